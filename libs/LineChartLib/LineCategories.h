@@ -0,0 +1,85 @@
+#pragma once
+
+#include <QColor>
+#include <QString>
+#include <QVector>
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "LineSeries.h"
+
+/**
+ * Dictionary-encoded per-point categories.
+ *
+ * Every point stores a 32-bit code into a small palette of labels and colors,
+ * so coloring millions of points costs four bytes per point instead of a
+ * string and a color each.
+ */
+class LineCategories
+{
+public:
+    using Code = std::uint32_t;
+    using CodeColumn = std::vector<Code, AlignedAllocator<Code, 64>>;
+
+    /** Code of points that do not belong to any category */
+    static constexpr Code NoCategory = std::numeric_limits<Code>::max();
+
+    std::size_t size() const { return m_codes.size(); }
+    bool isEmpty() const { return m_codes.empty(); }
+
+    /** Resize the code column, new points get \p fill */
+    void resize(std::size_t size, Code fill = NoCategory) { m_codes.resize(size, fill); }
+    void reserve(std::size_t capacity) { m_codes.reserve(capacity); }
+
+    /** Drop codes and palette, keeping the code column capacity */
+    void clear() { m_codes.clear(); m_labels.clear(); m_colors.clear(); }
+
+    /**
+     * Add a palette entry
+     * @param label Label shown for points of this category
+     * @param color Color used for points of this category
+     * @return Code of the new entry
+     */
+    Code addCategory(const QString& label, const QColor& color)
+    {
+        m_labels.append(label);
+        m_colors.append(color);
+        return static_cast<Code>(m_labels.size() - 1);
+    }
+
+    /** Copy the palette of \p other without its codes */
+    void copyPalette(const LineCategories& other)
+    {
+        m_labels = other.m_labels;
+        m_colors = other.m_colors;
+    }
+
+    int paletteSize() const { return m_labels.size(); }
+
+    Code code(std::size_t index) const { return m_codes[index]; }
+    void setCode(std::size_t index, Code code) { m_codes[index] = code; }
+
+    bool hasCategory(std::size_t index) const { return index < m_codes.size() && m_codes[index] != NoCategory; }
+
+    /** Label of the point at \p index, empty when it has no category */
+    QString label(std::size_t index) const { return hasCategory(index) ? m_labels[m_codes[index]] : QString(); }
+
+    /** Color of the point at \p index, invalid when it has no category */
+    QColor color(std::size_t index) const { return hasCategory(index) ? m_colors[m_codes[index]] : QColor(); }
+
+    const QString& paletteLabel(Code code) const { return m_labels[code]; }
+    const QColor& paletteColor(Code code) const { return m_colors[code]; }
+
+    Code* codeData() { return m_codes.data(); }
+    const Code* codeData() const { return m_codes.data(); }
+
+    CodeColumn& codes() { return m_codes; }
+    const CodeColumn& codes() const { return m_codes; }
+
+private:
+    CodeColumn          m_codes;
+    QVector<QString>    m_labels;
+    QVector<QColor>     m_colors;
+};
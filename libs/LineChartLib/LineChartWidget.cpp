@@ -5,62 +5,125 @@
 #include <algorithm>
 #include <cmath>
 #include <QPainterPath>
+#include <cfloat>
+#include <QHash>
+#include <utility>
+#include <iterator>
+#include <QPolygonF>
+#include <QFontMetrics>
 LineChartWidget::LineChartWidget(QWidget* parent)
     : QWidget(parent)
 {
     setMouseTracking(true);
 }
 
-void LineChartWidget::setData(const QVector<QPair<float, float>>& points,
-    const QVector<QPair<QString, QColor>>& categories,
+void LineChartWidget::setSeries(std::shared_ptr<const LineSeries> points,
+    std::shared_ptr<const LineSeries> originalPoints,
+    std::shared_ptr<const LineCategories> categories,
+    const QVariantMap& statLine,
+    const QString& title,
+    const QString& xAxisName,
+    const QString& yAxisName,
+    const QRectF& originalBounds)
+{
+    m_points = points ? std::move(points) : std::make_shared<const LineSeries>();
+    m_originalPoints = originalPoints ? std::move(originalPoints) : std::make_shared<const LineSeries>();
+    // Bounds supplied by the caller spare the scan in updateLod()
+    if (!originalBounds.isNull() && m_originalLod.series() != m_originalPoints) {
+        m_originalLod.build(m_originalPoints);
+        m_originalBounds = originalBounds;
+    }
+    m_categories = categories ? std::move(categories) : std::make_shared<const LineCategories>();
+    updateHasCategories();
+    m_statLine = statLine;
+    m_title = title;
+    m_xAxisName = xAxisName;
+    m_yAxisName = yAxisName;
+    updateLod();
+    update();
+}
+
+void LineChartWidget::updateHasCategories()
+{
+    m_hasCategories = m_categories->size() == m_points->size() &&
+        std::all_of(m_categories->codes().begin(), m_categories->codes().end(), [this](LineCategories::Code code) {
+            return code != LineCategories::NoCategory && m_categories->paletteColor(code).isValid();
+        });
+}
+
+void LineChartWidget::setOverlaySeries(std::vector<std::shared_ptr<const LineSeries>> overlays, const QStringList& names)
+{
+    m_overlays = std::move(overlays);
+    m_overlayNames = names;
+    updateLod();
+    update();
+}
+
+void LineChartWidget::setChangePoints(std::vector<float> positions)
+{
+    m_changePoints = std::move(positions);
+    update();
+}
+
+void LineChartWidget::setRangeBand(std::shared_ptr<const LineSeries> lower, std::shared_ptr<const LineSeries> upper)
+{
+    const bool valid = lower && upper && lower->size() == upper->size();
+    m_rangeLower = valid ? std::move(lower) : std::make_shared<const LineSeries>();
+    m_rangeUpper = valid ? std::move(upper) : std::make_shared<const LineSeries>();
+    updateLod();
+    update();
+}
+
+void LineChartWidget::setData(const LineSeries& points,
+    const LineCategories& categories,
     const QVariantMap& statLine,
     const QString& title,
     const QColor& lineColor)
 {
-    m_points = points;
-    m_categories = categories;
+    m_points = std::make_shared<const LineSeries>(points);
+    m_categories = std::make_shared<const LineCategories>(categories);
+    updateHasCategories();
     m_statLine = statLine;
     m_title = title;
     m_lineColor = lineColor;
+    updateLod();
     update();
 }
 
 void LineChartWidget::setData(const QVariantMap& root)
 {
-    QVector<QPair<float, float>> points;
-    QVector<QPair<QString, QColor>> categories;
+    auto points = std::make_shared<LineSeries>();
+    auto categories = std::make_shared<LineCategories>();
+    QHash<QString, LineCategories::Code> categoryCodes;
     QColor lineColor = QColor("#1f77b4");
     QVariantList dataList = root.value("data").toList();
+    points->reserve(dataList.size());
+    categories->resize(dataList.size());
+    const auto codeFor = [&categories, &categoryCodes](const QString& label, const QString& colorName) {
+        const QString key = label + QChar(0x1f) + colorName;
+        auto it = categoryCodes.constFind(key);
+        if (it == categoryCodes.constEnd())
+            it = categoryCodes.insert(key, categories->addCategory(label, colorName.isEmpty() ? QColor() : QColor(colorName)));
+        return it.value();
+        };
     for (const QVariant& v : dataList) {
         QVariantMap m = v.toMap();
         float x = m.value("x").toFloat();
         float y = m.value("y").toFloat();
-        points.append({ x, y });
         // Parse category if present
         if (m.contains("category")) {
             QVariant catVar = m.value("category");
             if (catVar.canConvert<QVariantList>()) {
                 QVariantList cat = catVar.toList();
                 if (cat.size() == 2)
-                    categories.append({ cat[1].toString(), QColor(cat[0].toString()) });
-                else
-                    categories.append({ "", QColor() });
+                    categories->setCode(points->size(), codeFor(cat[1].toString(), cat[0].toString()));
             }
             else if (catVar.canConvert<QString>()) {
-                categories.append({ catVar.toString(), QColor() });
+                categories->setCode(points->size(), codeFor(catVar.toString(), QString()));
             }
-            else {
-                categories.append({ "", QColor() });
-            }
-        }
-        else {
-            categories.append({ "", QColor() });
         }
+        points->append(x, y);
     }
-    QVariantMap statLine = root.value("statLine").toMap();
-    QString title = root.value("title").toString();
-    m_xAxisName = root.value("xAxisName", "X").toString();
-    m_yAxisName = root.value("yAxisName", "Y").toString();
     if (root.contains("lineColor")) {
         QVariant colorVar = root.value("lineColor");
         if (colorVar.canConvert<QColor>())
@@ -68,21 +131,21 @@ void LineChartWidget::setData(const QVariantMap& root)
         else
             lineColor = QColor(colorVar.toString());
     }
-    m_originalPoints.clear();
+    auto originalPoints = std::make_shared<LineSeries>();
     QVariantList origList = root.value("original").toList();
+    originalPoints->reserve(origList.size());
     for (const QVariant& v : origList) {
         QVariantMap m = v.toMap();
         float x = m.value("x").toFloat();
         float y = m.value("y").toFloat();
-        m_originalPoints.append({ x, y });
+        originalPoints->append(x, y);
     }
-    // Instead of calling setData(...), set members directly and update
-    m_points = points;
-    m_categories = categories;
-    m_statLine = statLine;
-    m_title = title;
     m_lineColor = lineColor;
-    update();
+    setSeries(std::move(points), std::move(originalPoints), std::move(categories),
+        root.value("statLine").toMap(),
+        root.value("title").toString(),
+        root.value("xAxisName", "X").toString(),
+        root.value("yAxisName", "Y").toString());
 }
 
 void LineChartWidget::resizeEvent(QResizeEvent*)
@@ -93,6 +156,7 @@ void LineChartWidget::setShowEnvelope(bool show)
 {
     if (m_showEnvelope != show) {
         m_showEnvelope = show;
+        m_drawIndicesValid = false;
         update(); // Redraw
     }
 }
@@ -103,60 +167,135 @@ void LineChartWidget::setShowStatLine(bool show)
         update();
     }
 }
+void LineChartWidget::setLodMode(LineLod::Mode mode)
+{
+    if (m_lodMode != mode) {
+        m_lodMode = mode;
+        m_drawIndicesValid = false;
+        update();
+    }
+}
+
+static QRectF seriesBounds(const LineSeries& series)
+{
+    const float* x = series.xData();
+    const float* y = series.yData();
+    const std::size_t n = series.size();
+    if (n == 0)
+        return QRectF();
+    float xMin = x[0], xMax = x[0], yMin = y[0], yMax = y[0];
+    for (std::size_t i = 0; i < n; ++i) {
+        xMin = std::min(xMin, x[i]);
+        xMax = std::max(xMax, x[i]);
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        yMin = std::min(yMin, y[i]);
+        yMax = std::max(yMax, y[i]);
+    }
+    return QRectF(QPointF(xMin, yMin), QPointF(xMax, yMax));
+}
+
+void LineChartWidget::updateLod()
+{
+    // Shared buffers are immutable, so an unchanged pointer means an unchanged pyramid and range
+    if (m_lod.series() != m_points) {
+        m_lod.build(m_points);
+        m_pointsBounds = seriesBounds(*m_points);
+    }
+    if (m_originalLod.series() != m_originalPoints) {
+        m_originalLod.build(m_originalPoints);
+        m_originalBounds = seriesBounds(*m_originalPoints);
+    }
+    if (m_rangeLowerLod.series() != m_rangeLower || m_rangeUpperLod.series() != m_rangeUpper) {
+        m_rangeLowerLod.build(m_rangeLower);
+        m_rangeUpperLod.build(m_rangeUpper);
+        const QRectF lowerBounds = seriesBounds(*m_rangeLower);
+        const QRectF upperBounds = seriesBounds(*m_rangeUpper);
+        m_rangeBounds = QRectF(lowerBounds.topLeft(), upperBounds.bottomRight());
+    }
+    m_overlayLods.resize(m_overlays.size());
+    m_overlayBounds.resize(m_overlays.size());
+    for (std::size_t i = 0; i < m_overlays.size(); ++i) {
+        if (m_overlayLods[i].series() != m_overlays[i]) {
+            m_overlayLods[i].build(m_overlays[i]);
+            m_overlayBounds[i] = m_overlays[i] ? seriesBounds(*m_overlays[i]) : QRectF();
+        }
+    }
+    m_drawIndicesValid = false;
+}
+
+void LineChartWidget::updateDrawIndices()
+{
+    // Selected per device pixel, so M4 stays pixel exact on high DPI screens
+    const QRectF bounds(QPointF(m_xMin, m_yMin), QPointF(m_xMax, m_yMax));
+    const int pixelWidth = std::max(1, static_cast<int>(std::ceil(m_plotArea.width() * devicePixelRatioF())));
+    if (m_drawIndicesValid && m_drawIndicesArea == m_plotArea && m_drawIndicesBounds == bounds && m_drawIndicesPixelWidth == pixelWidth)
+        return;
+
+    m_lod.select(m_xMin, m_xMax, pixelWidth, m_lodMode, m_drawIndices);
+    if (m_showEnvelope)
+        m_originalLod.select(m_xMin, m_xMax, pixelWidth, m_lodMode, m_originalDrawIndices);
+    else
+        m_originalDrawIndices.clear();
+    // The band keeps the extrema of its edges, whatever the line is downsampled with
+    m_rangeLowerLod.select(m_xMin, m_xMax, pixelWidth, LineLod::Mode::M4, m_rangeLowerDrawIndices);
+    m_rangeUpperLod.select(m_xMin, m_xMax, pixelWidth, LineLod::Mode::M4, m_rangeUpperDrawIndices);
+    m_overlayDrawIndices.resize(m_overlayLods.size());
+    for (std::size_t i = 0; i < m_overlayLods.size(); ++i)
+        m_overlayLods[i].select(m_xMin, m_xMax, pixelWidth, m_lodMode, m_overlayDrawIndices[i]);
+
+    m_drawIndicesArea = m_plotArea;
+    m_drawIndicesBounds = bounds;
+    m_drawIndicesPixelWidth = pixelWidth;
+    m_drawIndicesValid = true;
+}
+
 void LineChartWidget::updatePlotArea()
 {
     // Margins: left, right, top, bottom
     int l = 60, r = 30, t = 60, b = 40;
     m_plotArea = QRectF(l, t, width() - l - r, height() - t - b);
 
+    const int plotPixelWidth = std::max(0, qRound(m_plotArea.width() * devicePixelRatioF()));
+    if (plotPixelWidth != m_plotPixelWidth) {
+        m_plotPixelWidth = plotPixelWidth;
+        emit plotWidthChanged(m_plotPixelWidth);
+    }
+
     // Compute data bounds
-    if (m_points.size() < 2 && m_originalPoints.size() < 2) {
+    if (m_points->size() < 2 && m_originalPoints->size() < 2) {
         m_xMin = m_xMax = m_yMin = m_yMax = 0;
         return;
     }
 
-    bool hasSmoothed = m_points.size() >= 2;
-    bool hasOriginal = m_originalPoints.size() >= 2;
+    bool hasSmoothed = m_points->size() >= 2;
+    bool hasOriginal = m_originalPoints->size() >= 2;
 
-    double xMin, xMax, yMin, yMax;
+    double xMin = DBL_MAX, xMax = -DBL_MAX, yMin = DBL_MAX, yMax = -DBL_MAX;
+    const auto includeBounds = [&](const LineSeries& series, const QRectF& bounds) {
+        if (series.isEmpty())
+            return;
+        xMin = std::min(xMin, bounds.left());
+        xMax = std::max(xMax, bounds.right());
+        yMin = std::min(yMin, bounds.top());
+        yMax = std::max(yMax, bounds.bottom());
+        };
 
     if (m_showEnvelope && hasOriginal) {
         // Use both smoothed and original for bounds
-        xMin = hasSmoothed ? m_points[0].first : m_originalPoints[0].first;
-        xMax = xMin;
-        yMin = hasSmoothed ? m_points[0].second : m_originalPoints[0].second;
-        yMax = yMin;
-
-        if (hasSmoothed) {
-            for (const auto& pt : m_points) {
-                xMin = std::min(xMin, (double)pt.first);
-                xMax = std::max(xMax, (double)pt.first);
-                yMin = std::min(yMin, (double)pt.second);
-                yMax = std::max(yMax, (double)pt.second);
-            }
-        }
-        if (hasOriginal) {
-            for (const auto& pt : m_originalPoints) {
-                xMin = std::min(xMin, (double)pt.first);
-                xMax = std::max(xMax, (double)pt.first);
-                yMin = std::min(yMin, (double)pt.second);
-                yMax = std::max(yMax, (double)pt.second);
-            }
-        }
+        if (hasSmoothed)
+            includeBounds(*m_points, m_pointsBounds);
+        includeBounds(*m_originalPoints, m_originalBounds);
     }
     else {
         // Only use smoothed data for bounds
-        xMin = m_points[0].first;
-        xMax = xMin;
-        yMin = m_points[0].second;
-        yMax = yMin;
-        for (const auto& pt : m_points) {
-            xMin = std::min(xMin, (double)pt.first);
-            xMax = std::max(xMax, (double)pt.first);
-            yMin = std::min(yMin, (double)pt.second);
-            yMax = std::max(yMax, (double)pt.second);
-        }
+        includeBounds(*m_points, m_pointsBounds);
+    }
+    for (std::size_t i = 0; i < m_overlays.size() && i < m_overlayBounds.size(); ++i) {
+        if (m_overlays[i])
+            includeBounds(*m_overlays[i], m_overlayBounds[i]);
     }
+    includeBounds(*m_rangeUpper, m_rangeBounds);
 
     // Expand bounds a bit for aesthetics
     double xPad = (xMax - xMin) * 0.05;
@@ -169,6 +308,28 @@ void LineChartWidget::updatePlotArea()
     m_yMax = yMax + yPad;
 }
 
+void LineChartWidget::mapToScreen(const LineSeries& series, const std::vector<std::uint32_t>& indices, QPolygonF& polyline) const
+{
+    polyline.resize(static_cast<int>(indices.size()));
+    if (m_plotArea.width() <= 0 || m_plotArea.height() <= 0) {
+        std::fill(polyline.begin(), polyline.end(), QPointF());
+        return;
+    }
+
+    // dataToScreen() folded into one multiply-add per coordinate
+    const double xScale = m_plotArea.width() / (m_xMax - m_xMin);
+    const double yScale = m_plotArea.height() / (m_yMax - m_yMin);
+    const double xOffset = m_plotArea.left() - m_xMin * xScale;
+    const double yOffset = m_plotArea.bottom() + m_yMin * yScale;
+    const float* x = series.xData();
+    const float* y = series.yData();
+    QPointF* points = polyline.data();
+    for (std::size_t k = 0; k < indices.size(); ++k) {
+        const std::uint32_t i = indices[k];
+        points[k] = QPointF(xOffset + x[i] * xScale, yOffset - y[i] * yScale);
+    }
+}
+
 QPointF LineChartWidget::dataToScreen(float x, float y) const
 {
     if (m_plotArea.width() <= 0 || m_plotArea.height() <= 0)
@@ -177,19 +338,27 @@ QPointF LineChartWidget::dataToScreen(float x, float y) const
     double sy = m_plotArea.bottom() - (y - m_yMin) / (m_yMax - m_yMin) * m_plotArea.height();
     return QPointF(sx, sy);
 }
-static float interpolateY(const QVector<QPair<float, float>>& data, float x) {
+static float interpolateY(const LineSeries& data, float x, bool sortedByX) {
     if (data.isEmpty()) return 0.0f;
-    if (x <= data.first().first) return data.first().second;
-    if (x >= data.last().first) return data.last().second;
-    for (int i = 1; i < data.size(); ++i) {
-        if (data[i].first >= x) {
-            float x0 = data[i - 1].first, y0 = data[i - 1].second;
-            float x1 = data[i].first, y1 = data[i].second;
+    const std::size_t n = data.size();
+    if (x <= data.x(0)) return data.y(0);
+    if (x >= data.x(n - 1)) return data.y(n - 1);
+    if (sortedByX) {
+        const std::size_t i = std::lower_bound(data.xData(), data.xData() + n, x) - data.xData();
+        float x0 = data.x(i - 1), y0 = data.y(i - 1);
+        float x1 = data.x(i), y1 = data.y(i);
+        float t = (x - x0) / (x1 - x0);
+        return y0 + t * (y1 - y0);
+    }
+    for (std::size_t i = 1; i < n; ++i) {
+        if (data.x(i) >= x) {
+            float x0 = data.x(i - 1), y0 = data.y(i - 1);
+            float x1 = data.x(i), y1 = data.y(i);
             float t = (x - x0) / (x1 - x0);
             return y0 + t * (y1 - y0);
         }
     }
-    return data.last().second;
+    return data.y(n - 1);
 }
 float LineChartWidget::screenToDataX(int px) const
 {
@@ -209,7 +378,7 @@ void LineChartWidget::paintEvent(QPaintEvent*)
     p.fillRect(rect(), Qt::white);
 
     // No data
-    if (m_points.size() < 2) {
+    if (m_points->size() < 2) {
         p.setPen(QColor("#888"));
         p.setFont(QFont("sans", 18, QFont::Bold));
         p.drawText(rect(), Qt::AlignCenter, m_noDataMessage);
@@ -262,16 +431,17 @@ void LineChartWidget::paintEvent(QPaintEvent*)
     p.drawText(QRectF(-m_plotArea.height() / 2, -20, m_plotArea.height(), 20), Qt::AlignHCenter, m_yAxisName);
     p.restore();
 
-    bool hasCategories = m_categories.size() == m_points.size() &&
-        std::all_of(m_categories.begin(), m_categories.end(), [](const QPair<QString, QColor>& c) { return c.second.isValid(); });
     int barHeight = 12;
     int barY = static_cast<int>(m_plotArea.top()) - barHeight - 8;
     if (barY < 0) barY = 0;
-    if (hasCategories) {
-        for (int i = 0; i < m_points.size() - 1; ++i) {
-            QColor color = m_categories[i].second;
-            QPointF p0 = dataToScreen(m_points[i].first, m_yMax);
-            QPointF p1 = dataToScreen(m_points[i + 1].first, m_yMax);
+    updateDrawIndices();
+    const int numDrawn = static_cast<int>(m_drawIndices.size());
+    if (m_hasCategories) {
+        for (int k = 0; k < numDrawn - 1; ++k) {
+            const int i = m_drawIndices[k];
+            QColor color = m_categories->color(i);
+            QPointF p0 = dataToScreen(m_points->x(i), m_yMax);
+            QPointF p1 = dataToScreen(m_points->x(m_drawIndices[k + 1]), m_yMax);
             QRectF barRect(p0.x(), barY, p1.x() - p0.x(), barHeight);
             p.setPen(Qt::NoPen);
             p.setBrush(color);
@@ -285,11 +455,14 @@ void LineChartWidget::paintEvent(QPaintEvent*)
         }
     }
     // === SMOOTH GREY AREA BETWEEN SMOOTHED AND ORIGINAL (ENVELOPE) ===
-    if (m_showEnvelope && !m_points.isEmpty() && !m_originalPoints.isEmpty()) {
+    if (m_showEnvelope && !m_points->isEmpty() && !m_originalPoints->isEmpty()) {
         QVector<float> allX;
-        // Collect all unique X values from both lines
-        for (const auto& pt : m_points) allX.push_back(pt.first);
-        for (const auto& pt : m_originalPoints) allX.push_back(pt.first);
+        // Collect the X values of the drawn points of both lines
+        allX.reserve(static_cast<int>(m_drawIndices.size() + m_originalDrawIndices.size()));
+        for (const auto index : m_drawIndices)
+            allX.append(m_points->x(index));
+        for (const auto index : m_originalDrawIndices)
+            allX.append(m_originalPoints->x(index));
         std::sort(allX.begin(), allX.end());
         auto last = std::unique(allX.begin(), allX.end());
         allX.erase(last, allX.end());
@@ -298,8 +471,8 @@ void LineChartWidget::paintEvent(QPaintEvent*)
         // Top edge: max(smoothed, original) at each X
         bool first = true;
         for (float x : allX) {
-            float ySmoothed = interpolateY(m_points, x);
-            float yOriginal = interpolateY(m_originalPoints, x);
+            float ySmoothed = interpolateY(*m_points, x, m_lod.isSortedByX());
+            float yOriginal = interpolateY(*m_originalPoints, x, m_originalLod.isSortedByX());
             float yHigh = std::max(ySmoothed, yOriginal);
             QPointF pt = dataToScreen(x, yHigh);
             if (first) {
@@ -313,8 +486,8 @@ void LineChartWidget::paintEvent(QPaintEvent*)
         // Bottom edge: min(smoothed, original) at each X (reverse order)
         for (int i = allX.size() - 1; i >= 0; --i) {
             float x = allX[i];
-            float ySmoothed = interpolateY(m_points, x);
-            float yOriginal = interpolateY(m_originalPoints, x);
+            float ySmoothed = interpolateY(*m_points, x, m_lod.isSortedByX());
+            float yOriginal = interpolateY(*m_originalPoints, x, m_originalLod.isSortedByX());
             float yLow = std::min(ySmoothed, yOriginal);
             areaPath.lineTo(dataToScreen(x, yLow));
         }
@@ -325,17 +498,14 @@ void LineChartWidget::paintEvent(QPaintEvent*)
         p.setBrush(areaColor);
         p.drawPath(areaPath);
     }
+    // === RANGE BAND ===
+    drawRangeBand(p);
+    // === CHANGE POINTS ===
+    drawChangePoints(p);
+    // === OVERLAYS ===
+    drawOverlays(p);
     // === MAIN LINE (category colored segments) ===
-    for (int i = 0; i < m_points.size() - 1; ++i) {
-        QPointF p0 = dataToScreen(m_points[i].first, m_points[i].second);
-        QPointF p1 = dataToScreen(m_points[i + 1].first, m_points[i + 1].second);
-        QColor color = (hasCategories && m_categories[i].second.isValid()) ? m_categories[i].second : m_lineColor;
-        QPen pen(color, (i == m_hoveredLineIdx) ? 4 : 2);
-        if (i == m_hoveredLineIdx)
-            pen.setColor(QColor("#d62728"));
-        p.setPen(pen);
-        p.drawLine(p0, p1);
-    }
+    drawMainLine(p, m_hasCategories);
 
     // === STAT LINE ===
     if (m_showStatLine && !m_statLine.isEmpty()) {
@@ -351,6 +521,24 @@ void LineChartWidget::paintEvent(QPaintEvent*)
         QPointF s0 = dataToScreen(x1, y1);
         QPointF s1 = dataToScreen(x2, y2);
 
+        // Fitted trends carry the lines of their slope bounds, which cross at the pivot
+        if (m_statLine.contains("ci_start_y1")) {
+            const QPointF pivot = dataToScreen(m_statLine.value("pivot_x").toDouble(), m_statLine.value("pivot_y").toDouble());
+            QPainterPath fan;
+            fan.moveTo(dataToScreen(x1, m_statLine.value("ci_start_y1").toDouble()));
+            fan.lineTo(pivot);
+            fan.lineTo(dataToScreen(x2, m_statLine.value("ci_end_y1").toDouble()));
+            fan.lineTo(dataToScreen(x2, m_statLine.value("ci_end_y2").toDouble()));
+            fan.lineTo(pivot);
+            fan.lineTo(dataToScreen(x1, m_statLine.value("ci_start_y2").toDouble()));
+            fan.closeSubpath();
+            QColor fanColor = color;
+            fanColor.setAlpha(40);
+            p.setPen(Qt::NoPen);
+            p.setBrush(fanColor);
+            p.drawPath(fan);
+        }
+
         QPen statPen(color, 3, Qt::DashLine);
         p.setPen(statPen);
         p.drawLine(s0, s1);
@@ -370,7 +558,7 @@ void LineChartWidget::paintEvent(QPaintEvent*)
         }
         if (!endLabel.isEmpty()) {
             QPointF labelPos1 = s1 + QPointF(8, -8);
-            p.drawText(QRectF(labelPos1, QSizeF(120, 20)), Qt::AlignLeft | Qt::AlignTop, endLabel);
+            p.drawText(QRectF(labelPos1, QSizeF(240, 20)), Qt::AlignLeft | Qt::AlignTop, endLabel);
         }
     }
 
@@ -433,6 +621,124 @@ void LineChartWidget::paintEvent(QPaintEvent*)
     }*/
 }
 
+void LineChartWidget::drawOverlays(QPainter& p)
+{
+    if (m_overlays.empty())
+        return;
+
+    // Category10 without the blue of the main line
+    static const QColor palette[] = {
+        QColor("#ff7f0e"), QColor("#2ca02c"), QColor("#d62728"), QColor("#9467bd"), QColor("#8c564b"),
+        QColor("#e377c2"), QColor("#7f7f7f"), QColor("#bcbd22"), QColor("#17becf")
+    };
+    const auto overlayColor = [](std::size_t i) { return palette[i % std::size(palette)]; };
+
+    p.setBrush(Qt::NoBrush);
+    for (std::size_t i = 0; i < m_overlays.size() && i < m_overlayDrawIndices.size(); ++i) {
+        if (!m_overlays[i])
+            continue;
+        mapToScreen(*m_overlays[i], m_overlayDrawIndices[i], m_screenPoints);
+        p.setPen(QPen(overlayColor(i), 1.5));
+        p.drawPolyline(m_screenPoints);
+    }
+
+    // Legend in the top right corner of the plot, one row per overlay
+    const QFont legendFont("sans", 9);
+    const QFontMetrics fm(legendFont);
+    const int rowHeight = fm.height() + 2;
+    int labelWidth = 0;
+    for (const auto& name : m_overlayNames)
+        labelWidth = std::max(labelWidth, fm.horizontalAdvance(name));
+    const int rows = static_cast<int>(std::min<std::size_t>(m_overlays.size(), m_overlayNames.size()));
+    if (rows == 0)
+        return;
+    const QRectF legendRect(m_plotArea.right() - labelWidth - 36, m_plotArea.top() + 4, labelWidth + 32, rows * rowHeight + 6);
+    p.setPen(Qt::NoPen);
+    p.setBrush(QColor(255, 255, 255, 220));
+    p.drawRect(legendRect);
+    p.setFont(legendFont);
+    for (int row = 0; row < rows; ++row) {
+        const double y = legendRect.top() + 3 + row * rowHeight + rowHeight / 2.0;
+        p.setPen(QPen(overlayColor(row), 2));
+        p.drawLine(QPointF(legendRect.left() + 4, y), QPointF(legendRect.left() + 22, y));
+        p.setPen(QColor("#222"));
+        p.drawText(QRectF(legendRect.left() + 28, y - rowHeight / 2.0, labelWidth + 4, rowHeight), Qt::AlignLeft | Qt::AlignVCenter, m_overlayNames[row]);
+    }
+}
+
+void LineChartWidget::drawMainLine(QPainter& p, bool hasCategories)
+{
+    const std::size_t numDrawn = m_drawIndices.size();
+    if (numDrawn < 2)
+        return;
+
+    mapToScreen(*m_points, m_drawIndices, m_screenPoints);
+    const QPointF* points = m_screenPoints.constData();
+
+    // One polyline per run of segments of equal color, a segment takes the color of its start point
+    p.setBrush(Qt::NoBrush);
+    const std::size_t numSegments = numDrawn - 1;
+    for (std::size_t runBegin = 0; runBegin < numSegments;) {
+        std::size_t runEnd = numSegments;
+        QColor color = m_lineColor;
+        if (hasCategories) {
+            const auto code = m_categories->code(m_drawIndices[runBegin]);
+            runEnd = runBegin + 1;
+            while (runEnd < numSegments && m_categories->code(m_drawIndices[runEnd]) == code)
+                ++runEnd;
+            color = m_categories->paletteColor(code);
+        }
+        p.setPen(QPen(color, 2));
+        p.drawPolyline(points + runBegin, static_cast<int>(runEnd - runBegin + 1));
+        runBegin = runEnd;
+    }
+
+    // The hovered segment is drawn over the runs
+    if (m_hoveredLineIdx < 0)
+        return;
+    const auto last = m_drawIndices.end() - 1;
+    const auto hovered = std::lower_bound(m_drawIndices.begin(), last, static_cast<std::uint32_t>(m_hoveredLineIdx));
+    if (hovered == last || *hovered != static_cast<std::uint32_t>(m_hoveredLineIdx))
+        return;
+    const auto k = static_cast<std::size_t>(std::distance(m_drawIndices.begin(), hovered));
+    p.setPen(QPen(QColor("#d62728"), 4));
+    p.drawLine(points[k], points[k + 1]);
+}
+
+void LineChartWidget::drawRangeBand(QPainter& p)
+{
+    if (m_rangeUpperDrawIndices.size() < 2 || m_rangeLowerDrawIndices.size() < 2)
+        return;
+
+    // Upper edge left to right, lower edge back
+    QPolygonF band;
+    band.reserve(static_cast<int>(m_rangeUpperDrawIndices.size() + m_rangeLowerDrawIndices.size()));
+    for (const auto index : m_rangeUpperDrawIndices)
+        band.append(dataToScreen(m_rangeUpper->x(index), m_rangeUpper->y(index)));
+    for (auto it = m_rangeLowerDrawIndices.rbegin(); it != m_rangeLowerDrawIndices.rend(); ++it)
+        band.append(dataToScreen(m_rangeLower->x(*it), m_rangeLower->y(*it)));
+
+    QColor bandColor = m_lineColor;
+    bandColor.setAlpha(50);
+    p.setPen(Qt::NoPen);
+    p.setBrush(bandColor);
+    p.drawPolygon(band);
+}
+
+void LineChartWidget::drawChangePoints(QPainter& p)
+{
+    if (m_changePoints.empty())
+        return;
+
+    p.setPen(QPen(QColor(90, 90, 90, 160), 1, Qt::DashLine));
+    for (const float x : m_changePoints) {
+        if (x < m_xMin || x > m_xMax)
+            continue;
+        const double sx = dataToScreen(x, m_yMin).x();
+        p.drawLine(QPointF(sx, m_plotArea.top()), QPointF(sx, m_plotArea.bottom()));
+    }
+}
+
 void LineChartWidget::mouseMoveEvent(QMouseEvent* event)
 {
     int oldLine = m_hoveredLineIdx;
@@ -441,13 +747,13 @@ void LineChartWidget::mouseMoveEvent(QMouseEvent* event)
     m_hoveredLineIdx = findNearestLineSegment(event->pos(), minDist);
     m_hoveredBarIdx = findCategoryBarAt(event->pos());
 
-    if (m_hoveredBarIdx >= 0 && m_hoveredBarIdx < m_categories.size() && !m_categories[m_hoveredBarIdx].first.isEmpty()) {
-        showTooltip(event->pos(), m_categories[m_hoveredBarIdx].first);
+    if (m_hoveredBarIdx >= 0 && !m_categories->label(m_hoveredBarIdx).isEmpty()) {
+        showTooltip(event->pos(), m_categories->label(m_hoveredBarIdx));
     }
-    else if (m_hoveredLineIdx >= 0 && m_hoveredLineIdx < m_points.size() - 1) {
-        QString tip = QString("x: %1\ny: %2").arg(m_points[m_hoveredLineIdx].first).arg(m_points[m_hoveredLineIdx].second);
-        if (!m_categories.isEmpty() && !m_categories[m_hoveredLineIdx].first.isEmpty())
-            tip += "\nCategory: " + m_categories[m_hoveredLineIdx].first;
+    else if (m_hoveredLineIdx >= 0 && m_hoveredLineIdx < static_cast<int>(m_points->size()) - 1) {
+        QString tip = QString("x: %1\ny: %2").arg(m_points->x(m_hoveredLineIdx)).arg(m_points->y(m_hoveredLineIdx));
+        if (!m_categories->label(m_hoveredLineIdx).isEmpty())
+            tip += "\nCategory: " + m_categories->label(m_hoveredLineIdx);
         showTooltip(event->pos(), tip);
     }
     else {
@@ -467,11 +773,14 @@ void LineChartWidget::leaveEvent(QEvent*)
 
 int LineChartWidget::findNearestLineSegment(const QPoint& pos, double& minDist) const
 {
-    if (m_points.size() < 2) return -1;
+    if (m_points->size() < 2) return -1;
     int bestIdx = -1;
-    for (int i = 0; i < m_points.size() - 1; ++i) {
-        QPointF p0 = dataToScreen(m_points[i].first, m_points[i].second);
-        QPointF p1 = dataToScreen(m_points[i + 1].first, m_points[i + 1].second);
+    // Only the drawn segments can be hovered, indices refer to their start point
+    const int numDrawn = static_cast<int>(m_drawIndices.size());
+    for (int k = 0; k < numDrawn - 1; ++k) {
+        const int i = m_drawIndices[k];
+        QPointF p0 = dataToScreen(m_points->x(i), m_points->y(i));
+        QPointF p1 = dataToScreen(m_points->x(m_drawIndices[k + 1]), m_points->y(m_drawIndices[k + 1]));
         // Distance from mouse to line segment
         double dx = p1.x() - p0.x();
         double dy = p1.y() - p0.y();
@@ -490,15 +799,18 @@ int LineChartWidget::findNearestLineSegment(const QPoint& pos, double& minDist)
 
 int LineChartWidget::findCategoryBarAt(const QPoint& pos) const
 {
-    if (m_categories.size() != m_points.size() || m_points.size() < 2)
+    const int numPoints = static_cast<int>(m_points->size());
+    if (static_cast<int>(m_categories->size()) != numPoints || numPoints < 2)
         return -1;
     int barHeight = 12;
     int barY = m_plotArea.top() - barHeight - 8;
     if (pos.y() < barY || pos.y() > barY + barHeight)
         return -1;
-    for (int i = 0; i < m_points.size() - 1; ++i) {
-        QPointF p0 = dataToScreen(m_points[i].first, m_yMax);
-        QPointF p1 = dataToScreen(m_points[i + 1].first, m_yMax);
+    const int numDrawn = static_cast<int>(m_drawIndices.size());
+    for (int k = 0; k < numDrawn - 1; ++k) {
+        const int i = m_drawIndices[k];
+        QPointF p0 = dataToScreen(m_points->x(i), m_yMax);
+        QPointF p1 = dataToScreen(m_points->x(m_drawIndices[k + 1]), m_yMax);
         if (pos.x() >= std::min(p0.x(), p1.x()) && pos.x() <= std::max(p0.x(), p1.x()))
             return i;
     }
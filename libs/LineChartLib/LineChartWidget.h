@@ -6,7 +6,18 @@
 #include <QColor>
 #include <QVariantMap>
 #include <QString>
+#include <QStringList>
 #include <QRectF>
+#include <QPolygonF>
+
+class QPainter;
+
+#include <memory>
+#include <vector>
+
+#include "LineSeries.h"
+#include "LineCategories.h"
+#include "LineLod.h"
 
 class LineChartWidget : public QWidget
 {
@@ -14,15 +25,52 @@ class LineChartWidget : public QWidget
 public:
     explicit LineChartWidget(QWidget* parent = nullptr);
 
-    void setData(const QVector<QPair<float, float>>& points,
-        const QVector<QPair<QString, QColor>>& categories = {},
+    /**
+     * Show typed series without any QVariant round-trip.
+     * The buffers are shared with the caller and must not be modified afterwards.
+     * @param points Series drawn as the main line
+     * @param originalPoints Unsmoothed series used for the envelope
+     * @param categories Per-point categories of \p points, may be empty
+     * @param originalBounds X/Y range of \p originalPoints when the caller already knows it, null to scan the series
+     */
+    void setSeries(std::shared_ptr<const LineSeries> points,
+        std::shared_ptr<const LineSeries> originalPoints,
+        std::shared_ptr<const LineCategories> categories,
+        const QVariantMap& statLine = QVariantMap(),
+        const QString& title = QString(),
+        const QString& xAxisName = "X",
+        const QString& yAxisName = "Y",
+        const QRectF& originalBounds = QRectF());
+    /**
+     * Further series drawn over the main line in palette colors, with a legend.
+     * They share the X axis of the main series and count towards the plot bounds.
+     * @param overlays Series to draw, shared with the caller like in setSeries()
+     * @param names Legend entry of each overlay
+     */
+    void setOverlaySeries(std::vector<std::shared_ptr<const LineSeries>> overlays, const QStringList& names);
+    /** X positions marked with vertical lines across the plot, e.g. detected change points */
+    void setChangePoints(std::vector<float> positions);
+    /**
+     * Band filled between two series sharing their X values, e.g. the Y range of aggregated points.
+     * It counts towards the plot bounds; null or empty series hide it.
+     */
+    void setRangeBand(std::shared_ptr<const LineSeries> lower, std::shared_ptr<const LineSeries> upper);
+    void setData(const LineSeries& points,
+        const LineCategories& categories = {},
         const QVariantMap& statLine = QVariantMap(),
         const QString& title = QString(),
         const QColor& lineColor = QColor("#1f77b4"));
     void setData(const QVariantMap& root);
     void setShowEnvelope(bool show);
     void setShowStatLine(bool show);
+    /** Aggregation used when a series has more points than the plot has pixel columns */
+    void setLodMode(LineLod::Mode mode);
     void setNoDataMessage(const QString& msg);
+
+signals:
+    /** Emitted when the width of the plot area changes, in device pixels */
+    void plotWidthChanged(int width);
+
 protected:
     void paintEvent(QPaintEvent* event) override;
     void resizeEvent(QResizeEvent* event) override;
@@ -30,23 +78,59 @@ protected:
     void leaveEvent(QEvent* event) override;
 
 private:
-    QVector<QPair<float, float>> m_points;
-    QVector<QPair<QString, QColor>> m_categories;
+    std::shared_ptr<const LineSeries> m_points = std::make_shared<const LineSeries>();
+    std::shared_ptr<const LineCategories> m_categories = std::make_shared<const LineCategories>();
+    bool m_hasCategories = false;                       // Every point has a category with a palette color, set with the data
     QVariantMap m_statLine;
     QString m_title;
     QColor m_lineColor = QColor("#1f77b4");
     QString m_xAxisName = "X";
     QString m_yAxisName = "Y";
-    QVector<QPair<float, float>> m_originalPoints;
+    std::shared_ptr<const LineSeries> m_originalPoints = std::make_shared<const LineSeries>();
     QRectF m_plotArea;
     double m_xMin = 0, m_xMax = 0, m_yMin = 0, m_yMax = 0;
     bool m_showEnvelope = true;
     bool m_showStatLine = false;
+    LineLod m_lod;
+    LineLod m_originalLod;
+    LineLod::Mode m_lodMode = LineLod::Mode::M4;
+    std::vector<std::shared_ptr<const LineSeries>> m_overlays;
+    QStringList m_overlayNames;
+    std::vector<LineLod> m_overlayLods;
+    QRectF m_pointsBounds;                              // X/Y range of each series, taken once per new buffer
+    QRectF m_originalBounds;
+    std::vector<QRectF> m_overlayBounds;
+    std::vector<std::vector<std::uint32_t>> m_overlayDrawIndices;
+    std::vector<float> m_changePoints;
+    std::shared_ptr<const LineSeries> m_rangeLower = std::make_shared<const LineSeries>();
+    std::shared_ptr<const LineSeries> m_rangeUpper = std::make_shared<const LineSeries>();
+    LineLod m_rangeLowerLod;
+    LineLod m_rangeUpperLod;
+    QRectF m_rangeBounds;
+    std::vector<std::uint32_t> m_rangeLowerDrawIndices;
+    std::vector<std::uint32_t> m_rangeUpperDrawIndices;
+    std::vector<std::uint32_t> m_drawIndices;           // Points of m_points that are drawn
+    std::vector<std::uint32_t> m_originalDrawIndices;   // Points of m_originalPoints that are drawn
+    QPolygonF m_screenPoints;                           // Screen positions of the line being drawn, reused between paints
+    QRectF m_drawIndicesArea;                           // Plot area and bounds m_drawIndices were selected for
+    QRectF m_drawIndicesBounds;
+    int m_drawIndicesPixelWidth = 0;                    // Device pixel width m_drawIndices were selected for
+    bool m_drawIndicesValid = false;
+    int m_plotPixelWidth = 0;                           // Last width reported by plotWidthChanged
     int m_hoveredLineIdx = -1;
     int m_hoveredBarIdx = -1;
     QString m_noDataMessage = "No data available or insufficient data for chart.";
     void updatePlotArea();
+    void updateLod();
+    void updateHasCategories();
+    void updateDrawIndices();
+    void drawMainLine(QPainter& p, bool hasCategories);
+    void drawOverlays(QPainter& p);
+    void drawChangePoints(QPainter& p);
+    void drawRangeBand(QPainter& p);
     QPointF dataToScreen(float x, float y) const;
+    /** Screen positions of the points \p indices of \p series, written into \p polyline */
+    void mapToScreen(const LineSeries& series, const std::vector<std::uint32_t>& indices, QPolygonF& polyline) const;
     float screenToDataX(int px) const;
     float screenToDataY(int py) const;
     int findNearestLineSegment(const QPoint& pos, double& minDist) const;
@@ -0,0 +1,216 @@
+#include "LineLod.h"
+
+#include <algorithm>
+#include <cmath>
+
+void LineLod::clear()
+{
+    m_series.reset();
+    m_sortedByX = false;
+    m_minLevels.clear();
+    m_maxLevels.clear();
+}
+
+void LineLod::build(std::shared_ptr<const LineSeries> series)
+{
+    clear();
+    m_series = std::move(series);
+    if (!m_series || m_series->isEmpty())
+        return;
+
+    const float* x = m_series->xData();
+    const float* y = m_series->yData();
+    const std::size_t n = m_series->size();
+    m_sortedByX = std::is_sorted(x, x + n);
+
+    // First level aggregates the raw points, every further level the one below it
+    std::size_t count = n;
+    while (count > 1) {
+        const std::size_t blocks = (count + kFanout - 1) / kFanout;
+        const bool fromPoints = m_minLevels.empty();
+
+        std::vector<std::uint32_t> minLevel(blocks), maxLevel(blocks);
+        for (std::size_t block = 0; block < blocks; ++block) {
+            const std::size_t begin = block * kFanout;
+            const std::size_t end = std::min(begin + kFanout, count);
+
+            std::uint32_t minIndex = fromPoints ? static_cast<std::uint32_t>(begin) : m_minLevels.back()[begin];
+            std::uint32_t maxIndex = fromPoints ? static_cast<std::uint32_t>(begin) : m_maxLevels.back()[begin];
+            for (std::size_t i = begin + 1; i < end; ++i) {
+                const std::uint32_t candidateMin = fromPoints ? static_cast<std::uint32_t>(i) : m_minLevels.back()[i];
+                const std::uint32_t candidateMax = fromPoints ? static_cast<std::uint32_t>(i) : m_maxLevels.back()[i];
+                if (y[candidateMin] < y[minIndex])
+                    minIndex = candidateMin;
+                if (y[candidateMax] > y[maxIndex])
+                    maxIndex = candidateMax;
+            }
+            minLevel[block] = minIndex;
+            maxLevel[block] = maxIndex;
+        }
+
+        m_minLevels.push_back(std::move(minLevel));
+        m_maxLevels.push_back(std::move(maxLevel));
+        count = blocks;
+    }
+}
+
+void LineLod::rangeMinMax(std::size_t begin, std::size_t end, std::uint32_t& minIndex, std::uint32_t& maxIndex) const
+{
+    const float* y = m_series->yData();
+    minIndex = maxIndex = static_cast<std::uint32_t>(begin);
+
+    // Walk up the pyramid, consuming unaligned blocks at each level and
+    // leaving the aligned middle part to the coarser level above
+    std::size_t a = begin, b = end;
+    for (std::size_t level = 0; a < b; ++level) {
+        const auto consume = [&](std::size_t block) {
+            const std::uint32_t candidateMin = level == 0 ? static_cast<std::uint32_t>(block) : m_minLevels[level - 1][block];
+            const std::uint32_t candidateMax = level == 0 ? static_cast<std::uint32_t>(block) : m_maxLevels[level - 1][block];
+            if (y[candidateMin] < y[minIndex])
+                minIndex = candidateMin;
+            if (y[candidateMax] > y[maxIndex])
+                maxIndex = candidateMax;
+            };
+
+        if (level == m_minLevels.size()) {
+            for (; a < b; ++a)
+                consume(a);
+            break;
+        }
+
+        for (; a < b && a % kFanout != 0; ++a)
+            consume(a);
+        for (; a < b && b % kFanout != 0; --b)
+            consume(b - 1);
+
+        a /= kFanout;
+        b /= kFanout;
+    }
+}
+
+void LineLod::appendM4(std::size_t begin, std::size_t end, std::vector<std::uint32_t>& indices) const
+{
+    if (begin >= end)
+        return;
+
+    std::uint32_t minIndex, maxIndex;
+    rangeMinMax(begin, end, minIndex, maxIndex);
+
+    std::uint32_t candidates[4] = {
+        static_cast<std::uint32_t>(begin),
+        std::min(minIndex, maxIndex),
+        std::max(minIndex, maxIndex),
+        static_cast<std::uint32_t>(end - 1)
+    };
+
+    for (const auto index : candidates) {
+        if (indices.empty() || indices.back() < index)
+            indices.push_back(index);
+    }
+}
+
+void LineLod::selectLttb(std::size_t begin, std::size_t end, std::size_t threshold, std::vector<std::uint32_t>& indices) const
+{
+    const float* x = m_series->xData();
+    const float* y = m_series->yData();
+    const std::size_t count = end - begin;
+
+    // The first and last point are always kept, the rest is split into threshold - 2 buckets
+    const double bucketSize = static_cast<double>(count - 2) / static_cast<double>(threshold - 2);
+    const auto bucketBegin = [begin, bucketSize, end](std::size_t bucket) {
+        return std::min(begin + 1 + static_cast<std::size_t>(bucket * bucketSize), end - 1);
+        };
+
+    std::size_t previous = begin;
+    indices.push_back(static_cast<std::uint32_t>(previous));
+
+    for (std::size_t bucket = 0; bucket < threshold - 2; ++bucket) {
+        // Average of the next bucket, or the last point for the final bucket
+        const std::size_t nextBegin = bucketBegin(bucket + 1);
+        const std::size_t nextEnd = std::max(bucketBegin(bucket + 2), nextBegin + 1);
+        double averageX = 0.0, averageY = 0.0;
+        for (std::size_t i = nextBegin; i < nextEnd; ++i) {
+            averageX += x[i];
+            averageY += y[i];
+        }
+        averageX /= static_cast<double>(nextEnd - nextBegin);
+        averageY /= static_cast<double>(nextEnd - nextBegin);
+
+        // Keep the point spanning the largest triangle with the previous pick and that average
+        const std::size_t currentBegin = bucketBegin(bucket);
+        const std::size_t currentEnd = std::max(nextBegin, currentBegin + 1);
+        double largestArea = -1.0;
+        std::size_t selected = currentBegin;
+        for (std::size_t i = currentBegin; i < currentEnd; ++i) {
+            const double area = std::abs((x[previous] - averageX) * (y[i] - y[previous]) - (x[previous] - x[i]) * (averageY - y[previous]));
+            if (area > largestArea) {
+                largestArea = area;
+                selected = i;
+            }
+        }
+
+        if (selected > previous) {
+            indices.push_back(static_cast<std::uint32_t>(selected));
+            previous = selected;
+        }
+    }
+
+    if (end - 1 > previous)
+        indices.push_back(static_cast<std::uint32_t>(end - 1));
+}
+
+void LineLod::select(double xMin, double xMax, int pixelWidth, Mode mode, std::vector<std::uint32_t>& indices) const
+{
+    indices.clear();
+    if (!m_series || m_series->isEmpty())
+        return;
+
+    const float* x = m_series->xData();
+    const std::size_t n = m_series->size();
+    const std::size_t columns = static_cast<std::size_t>(std::max(pixelWidth, 1));
+
+    // Visible index range, padded by one point on either side so lines run into the plot edges
+    std::size_t begin = 0, end = n;
+    if (m_sortedByX) {
+        begin = static_cast<std::size_t>(std::lower_bound(x, x + n, static_cast<float>(xMin)) - x);
+        end = static_cast<std::size_t>(std::upper_bound(x, x + n, static_cast<float>(xMax)) - x);
+        begin = begin > 0 ? begin - 1 : 0;
+        end = std::min(end + 1, n);
+    }
+
+    const std::size_t count = end > begin ? end - begin : 0;
+    if (count <= 4 * columns) {
+        indices.resize(count);
+        for (std::size_t i = 0; i < count; ++i)
+            indices[i] = static_cast<std::uint32_t>(begin + i);
+        return;
+    }
+
+    if (mode == Mode::Lttb) {
+        const std::size_t threshold = std::max<std::size_t>(2 * columns, 3);
+        indices.reserve(threshold);
+        selectLttb(begin, end, threshold, indices);
+        return;
+    }
+
+    indices.reserve(4 * columns + 2);
+
+    if (!m_sortedByX) {
+        for (std::size_t column = 0; column < columns; ++column)
+            appendM4(begin + count * column / columns, begin + count * (column + 1) / columns, indices);
+        return;
+    }
+
+    // Pixel columns as X intervals; the padding points fall into the outer columns
+    const double columnWidth = (xMax - xMin) / static_cast<double>(columns);
+    std::size_t columnBegin = begin;
+    for (std::size_t column = 0; column < columns; ++column) {
+        std::size_t columnEnd = end;
+        if (column + 1 < columns) {
+            const float edge = static_cast<float>(xMin + columnWidth * static_cast<double>(column + 1));
+            columnEnd = static_cast<std::size_t>(std::lower_bound(x + columnBegin, x + end, edge) - x);
+        }
+        appendM4(columnBegin, columnEnd, indices);
+        columnBegin = columnEnd;
+    }
+}
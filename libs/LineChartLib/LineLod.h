@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "LineSeries.h"
+
+/**
+ * Level-of-detail selection for drawing a line series at a given pixel width.
+ *
+ * build() computes a pyramid of per-block Y minimum and maximum indices once per
+ * series. select() then reduces the visible range to the points that are actually
+ * distinguishable on screen:
+ *
+ *  - M4 keeps the first, last, minimum and maximum point of every pixel column,
+ *    which renders pixel-identical to the full series with at most 4 points per
+ *    column. The column extrema are range queries on the pyramid, so a column
+ *    costs O(log n) no matter how many points it covers.
+ *  - LTTB (largest triangle three buckets) keeps two points per column chosen for
+ *    visual shape rather than exact extrema.
+ *
+ * Columns are X intervals when X is sorted, otherwise equally sized index ranges.
+ */
+class LineLod
+{
+public:
+    enum class Mode { M4, Lttb };
+
+    /** Build the pyramid for \p series, which must not change while it is in use */
+    void build(std::shared_ptr<const LineSeries> series);
+    void clear();
+
+    const std::shared_ptr<const LineSeries>& series() const { return m_series; }
+    bool isSortedByX() const { return m_sortedByX; }
+
+    /**
+     * Select the points to draw
+     * @param xMin Left edge of the visible X range
+     * @param xMax Right edge of the visible X range
+     * @param pixelWidth Number of pixel columns the range spans
+     * @param mode Aggregation used when the visible range has more points than the columns can show
+     * @param indices Receives the ascending indices of the selected points
+     */
+    void select(double xMin, double xMax, int pixelWidth, Mode mode, std::vector<std::uint32_t>& indices) const;
+
+private:
+    /** Indices of the minimum and maximum Y in [begin, end), which must not be empty */
+    void rangeMinMax(std::size_t begin, std::size_t end, std::uint32_t& minIndex, std::uint32_t& maxIndex) const;
+
+    /** Append first, minimum, maximum and last point of [begin, end) in index order */
+    void appendM4(std::size_t begin, std::size_t end, std::vector<std::uint32_t>& indices) const;
+
+    void selectLttb(std::size_t begin, std::size_t end, std::size_t threshold, std::vector<std::uint32_t>& indices) const;
+
+private:
+    static constexpr std::size_t kFanout = 8;
+
+    std::shared_ptr<const LineSeries> m_series;
+    bool m_sortedByX = false;
+
+    // Level l holds one entry per block of kFanout^(l + 1) points
+    std::vector<std::vector<std::uint32_t>> m_minLevels;
+    std::vector<std::vector<std::uint32_t>> m_maxLevels;
+};
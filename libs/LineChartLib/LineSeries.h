@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * Allocator that hands out storage aligned to \p Alignment bytes.
+ *
+ * Elements are default-initialized, so resizing a column of floats does not
+ * zero memory that is about to be overwritten anyway.
+ */
+template <typename T, std::size_t Alignment = 64>
+class AlignedAllocator
+{
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() noexcept = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    T* allocate(std::size_t count)
+    {
+        if (count > std::numeric_limits<std::size_t>::max() / sizeof(T))
+            throw std::bad_array_new_length();
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T* pointer, std::size_t) noexcept
+    {
+        ::operator delete(pointer, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    void construct(U* pointer) noexcept
+    {
+        ::new (static_cast<void*>(pointer)) U;
+    }
+
+    template <typename U, typename... Args>
+    void construct(U* pointer, Args&&... args)
+    {
+        ::new (static_cast<void*>(pointer)) U(std::forward<Args>(args)...);
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+};
+
+/**
+ * Line series stored as separate, 64-byte aligned X and Y columns.
+ *
+ * Resizing and clearing keep the allocated capacity, so a series that is
+ * reused across pipeline runs only allocates when it has to grow.
+ */
+class LineSeries
+{
+public:
+    using Column = std::vector<float, AlignedAllocator<float, 64>>;
+
+    LineSeries() = default;
+    explicit LineSeries(std::size_t size) { resize(size); }
+
+    std::size_t size() const { return m_x.size(); }
+    std::size_t capacity() const { return m_x.capacity(); }
+    bool isEmpty() const { return m_x.empty(); }
+
+    void resize(std::size_t size) { m_x.resize(size); m_y.resize(size); }
+    void reserve(std::size_t capacity) { m_x.reserve(capacity); m_y.reserve(capacity); }
+    void clear() { m_x.clear(); m_y.clear(); }
+
+    void append(float x, float y) { m_x.push_back(x); m_y.push_back(y); }
+
+    /** Swap the X and Y columns without copying */
+    void swapAxes() { m_x.swap(m_y); }
+
+    void swap(LineSeries& other) noexcept { m_x.swap(other.m_x); m_y.swap(other.m_y); }
+
+    float x(std::size_t index) const { return m_x[index]; }
+    float y(std::size_t index) const { return m_y[index]; }
+
+    float* xData() { return m_x.data(); }
+    float* yData() { return m_y.data(); }
+    const float* xData() const { return m_x.data(); }
+    const float* yData() const { return m_y.data(); }
+
+    Column& xColumn() { return m_x; }
+    Column& yColumn() { return m_y; }
+    const Column& xColumn() const { return m_x; }
+    const Column& yColumn() const { return m_y; }
+
+private:
+    Column m_x;
+    Column m_y;
+};
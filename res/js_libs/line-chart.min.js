@@ -15,13 +15,11 @@
                 a.w = window.innerWidth;
                 a.h = window.innerHeight;
 
-                var data = (input && input.data) ? input.data : (Array.isArray(input) ? input : []);
+                var points = LineChart.series(input);
                 var statLine = input && input.statLine ? input.statLine : undefined;
                 var title = input && input.title ? input.title : a.title;
                 var mainLineColor = (input && input.lineColor) ? input.lineColor : "#000";
 
-                if (!Array.isArray(data)) data = [];
-                data = data.filter(d => d && d.x !== undefined && d.y !== undefined);
 
                 var margin = a.margin,
                     width = a.w - margin.left - margin.right,
@@ -46,7 +44,11 @@
 
                 // === CATEGORY COLOR BAR (above chart area, width according to x positions) ===
                 // Only show if ALL data points have a valid category
-                let hasCategories = data.length > 1 && data.every(d => d.category !== undefined && d.category !== null && d.category !== "");
+                let hasCategories = points.length > 1;
+                for (let i = 0; hasCategories && i < points.length; ++i) {
+                    const category = points.category(i);
+                    hasCategories = category !== undefined && category !== null && category !== "";
+                }
                 let tooltipDiv = null;
                 if (hasCategories) {
                     let barHeight = 10;
@@ -54,21 +56,19 @@
                     let margin = a.margin;
                     let width = a.w - margin.left - margin.right;
 
-                    let xVals = data.map(d => d.x);
-                    let xDomain = d3.extent(xVals);
+                    let xDomain = LineChart.extent(points.length, points.x);
                     let xBar = d3.scaleLinear()
                         .domain(xDomain)
                         .range([margin.left, a.w - margin.right]);
 
                     let svgBar = d3.select(this);
 
-                    for (let i = 0; i < data.length - 1; ++i) {
-                        let p0 = data[i];
-                        let p1 = data[i + 1];
-                        let color = Array.isArray(p0.category) ? p0.category[0] : p0.category;
-                        let rectWidth = Math.max(0, xBar(p1.x) - xBar(p0.x));
+                    for (let i = 0; i < points.length - 1; ++i) {
+                        let category = points.category(i);
+                        let color = Array.isArray(category) ? category[0] : category;
+                        let rectWidth = Math.max(0, xBar(points.x(i + 1)) - xBar(points.x(i)));
                         let rect = svgBar.append("rect")
-                            .attr("x", xBar(p0.x))
+                            .attr("x", xBar(points.x(i)))
                             .attr("y", barY)
                             .attr("width", rectWidth)
                             .attr("height", barHeight)
@@ -78,13 +78,12 @@
                             .attr("data-bar-idx", i);
                         barRects.push(rect);
                     }
-                    if (data.length === 2) {
-                        let pLast = data[1];
-                        let pPrev = data[0];
-                        let color = Array.isArray(pLast.category) ? pLast.category[0] : pLast.category;
-                        let lastWidth = Math.max(2, xBar(pLast.x) - xBar(pPrev.x));
+                    if (points.length === 2) {
+                        let category = points.category(1);
+                        let color = Array.isArray(category) ? category[0] : category;
+                        let lastWidth = Math.max(2, xBar(points.x(1)) - xBar(points.x(0)));
                         svgBar.append("rect")
-                            .attr("x", xBar(pLast.x))
+                            .attr("x", xBar(points.x(1)))
                             .attr("y", barY)
                             .attr("width", lastWidth)
                             .attr("height", barHeight)
@@ -110,7 +109,7 @@
                 }
                 // === END CATEGORY COLOR BAR ===
 
-                if (!data || data.length === 0) {
+                if (points.length === 0) {
                     d3.select(this)
                         .append("text")
                         .attr("class", "no-data-message")
@@ -130,8 +129,8 @@
                     .append("g")
                     .attr("transform", `translate(${margin.left},${margin.top + (a.title ? a.titleHeight : 0)})`);
 
-                let xVals = data.map(d => d.x);
-                let yVals = data.map(d => d.y);
+                let xVals = LineChart.extent(points.length, points.x);
+                let yVals = LineChart.extent(points.length, points.y);
                 if (statLine) {
                     if (statLine.start_x !== undefined && statLine.end_x !== undefined)
                         xVals.push(+statLine.start_x, +statLine.end_x);
@@ -155,18 +154,17 @@
                     .call(d3.axisLeft(y));
 
                 // Draw line segments and store references
-                for (let i = 0; i < data.length - 1; ++i) {
-                    let p0 = data[i];
-                    let p1 = data[i + 1];
+                for (let i = 0; i < points.length - 1; ++i) {
+                    let category = hasCategories ? points.category(i) : undefined;
                     let catLabel = hasCategories
-                        ? (Array.isArray(p0.category) && p0.category.length > 1 ? p0.category[1] : (p0.category || ""))
+                        ? (Array.isArray(category) && category.length > 1 ? category[1] : (category || ""))
                         : "";
 
                     let line = svg.append("line")
-                        .attr("x1", x(p0.x))
-                        .attr("y1", y(p0.y))
-                        .attr("x2", x(p1.x))
-                        .attr("y2", y(p1.y))
+                        .attr("x1", x(points.x(i)))
+                        .attr("y1", y(points.y(i)))
+                        .attr("x2", x(points.x(i + 1)))
+                        .attr("y2", y(points.y(i + 1)))
                         .attr("stroke", mainLineColor)
                         .attr("stroke-width", 2)
                         .attr("fill", "none")
@@ -199,8 +197,8 @@
                 // Bar hover: highlight both bar and line, show tooltip
                 if (hasCategories) {
                     for (let i = 0; i < barRects.length; ++i) {
-                        let p0 = data[i];
-                        let catLabel = Array.isArray(p0.category) && p0.category.length > 1 ? p0.category[1] : (p0.category || "");
+                        let category = points.category(i);
+                        let catLabel = Array.isArray(category) && category.length > 1 ? category[1] : (category || "");
 
                         barRects[i]
                             .on("mouseover", function (event) {
@@ -283,7 +281,7 @@
                     .attr("class", "legend")
                     .attr("transform", `translate(${legendPos[0]},${legendPos[1]})`);
 
-                if (data.length > 0) {
+                if (points.length > 0) {
                     legend.append("line")
                         .attr("x1", 0).attr("y1", 0).attr("x2", 30).attr("y2", 0)
                         .attr("stroke", mainLineColor)
@@ -338,6 +336,40 @@
         };
         return chart;
     },
+    // Accessor view of the points of a chart input. input.columns holds the typed arrays
+    // of the binary buffers ({x, y, codes, palette}) and is indexed directly, so no
+    // per-point objects are built; input.data is an array of {x, y, category} objects
+    series: function (input) {
+        var columns = input && input.columns;
+        if (columns && columns.x && columns.y) {
+            var xs = columns.x, ys = columns.y, codes = columns.codes, palette = columns.palette || [];
+            return {
+                length: Math.min(xs.length, ys.length),
+                x: i => xs[i],
+                y: i => ys[i],
+                category: i => codes && codes[i] < palette.length ? palette[codes[i]] : undefined
+            };
+        }
+        var data = (input && input.data) ? input.data : (Array.isArray(input) ? input : []);
+        if (!Array.isArray(data)) data = [];
+        data = data.filter(d => d && d.x !== undefined && d.y !== undefined);
+        return {
+            length: data.length,
+            x: i => data[i].x,
+            y: i => data[i].y,
+            category: i => data[i].category
+        };
+    },
+    // [min, max] of value(i) over [0, length)
+    extent: function (length, value) {
+        var min = Infinity, max = -Infinity;
+        for (var i = 0; i < length; ++i) {
+            var v = value(i);
+            if (v < min) min = v;
+            if (v > max) max = v;
+        }
+        return length > 0 ? [min, max] : [undefined, undefined];
+    },
     draw: function (a, b, c) {
         var d = LineChart.chart().config(c),
             e = d.config();
@@ -359,9 +391,7 @@ if (typeof window !== "undefined") {
             if (window.chart && window._lastChartData) {
                 d3.select("div#container").select("svg").remove();
                 d3.select("div#container").selectAll(".no-data-message").remove();
-                var d = window._lastChartData;
-                var data = d && d.data ? d.data : [];
-                if (!Array.isArray(data) || data.length === 0) {
+                if (LineChart.series(window._lastChartData).length === 0) {
                     d3.select("div#container")
                         .append("div")
                         .attr("class", "no-data-message")
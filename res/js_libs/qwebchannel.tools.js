@@ -8,6 +8,10 @@ try {
             drawChart(arguments[0]);
         });
 
+        QtBridge.qt_js_setChartBuffersInJS.connect(function () {
+            loadChartBuffers(arguments[0]);
+        });
+
         isQtAvailable = true;
         notifyBridgeAvailable();
     });
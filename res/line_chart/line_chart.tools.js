@@ -1,16 +1,4 @@
 function drawChart(d) {
-    d3.select("div#container").select("svg").remove();
-    d3.select("div#container").selectAll(".no-data-message").remove();
-
-    if (typeof window.chart === "undefined") {
-        if (typeof LineChart !== "undefined" && typeof LineChart.chart === "function") {
-            window.chart = LineChart.chart();
-        } else {
-            console.error("Chart object is not defined.");
-            return;
-        }
-    }
-
     let parsedData, statLine, title, lineColor;
     if (d && d.data && Array.isArray(d.data)) {
         parsedData = d.data
@@ -45,7 +33,80 @@ function drawChart(d) {
         lineColor = undefined;
     }
 
-    if (!parsedData || parsedData.length < 2) {
+    renderChart(parsedData, statLine, title, lineColor);
+}
+
+// Version of the most recently announced chart buffers, fetches of older versions are dropped
+var latestBufferVersion = null;
+
+function fetchChartBuffer(url) {
+    return fetch(url).then(function (response) {
+        if (!response.ok) {
+            throw new Error("could not fetch " + url + " (" + response.status + ")");
+        }
+        return response.arrayBuffer();
+    });
+}
+
+// Loads the binary series announced by qt_js_setChartBuffersInJS and draws them
+function loadChartBuffers(meta) {
+    latestBufferVersion = meta ? meta.version : null;
+
+    if (!meta || !meta.buffers) {
+        renderChart([], meta && meta.statLine, meta && meta.title, meta && meta.lineColor);
+        return;
+    }
+
+    const version = meta.version;
+    const requests = [fetchChartBuffer(meta.buffers.x), fetchChartBuffer(meta.buffers.y)];
+    if (meta.buffers.codes) {
+        requests.push(fetchChartBuffer(meta.buffers.codes));
+    }
+
+    Promise.all(requests).then(function (buffers) {
+        if (version !== latestBufferVersion) {
+            return;
+        }
+
+        const xs = new Float32Array(buffers[0]);
+        const ys = new Float32Array(buffers[1]);
+        let codes = null;
+        if (buffers.length > 2) {
+            codes = meta.codeType === "uint32" ? new Uint32Array(buffers[2]) : new Uint16Array(buffers[2]);
+        }
+
+        // Points share the palette entries, unlabeled entries mean no category
+        const palette = (meta.palette || []).map(function (entry) {
+            return entry && entry[1] ? entry : undefined;
+        });
+
+        // The chart indexes the typed arrays directly, no object is built per point
+        renderChart({ x: xs, y: ys, codes: codes, palette: palette }, meta.statLine, meta.title, meta.lineColor);
+    }).catch(function (error) {
+        log("LineViewJSPlugin: could not load chart buffers: " + error);
+    });
+}
+
+// points is either an array of {x, y, category} objects or the typed columns {x, y, codes, palette}
+function renderChart(points, statLine, title, lineColor) {
+    d3.select("div#container").select("svg").remove();
+    d3.select("div#container").selectAll(".no-data-message").remove();
+
+    if (typeof window.chart === "undefined") {
+        if (typeof LineChart !== "undefined" && typeof LineChart.chart === "function") {
+            window.chart = LineChart.chart();
+        } else {
+            console.error("Chart object is not defined.");
+            return;
+        }
+    }
+
+    const chartData = Array.isArray(points) ? { data: points } : { columns: points };
+    chartData.statLine = statLine;
+    chartData.title = title;
+    chartData.lineColor = lineColor;
+
+    if (LineChart.series(chartData).length < 2) {
         d3.select("div#container")
             .append("div")
             .attr("class", "no-data-message")
@@ -54,7 +115,7 @@ function drawChart(d) {
         return;
     }
 
-    window._lastChartData = { data: parsedData, statLine: statLine, title: title, lineColor: lineColor };
+    window._lastChartData = chartData;
 
     window.chart.config({
         containerClass: 'line-chart',
@@ -68,7 +129,7 @@ function drawChart(d) {
         .attr("preserveAspectRatio", "xMinYMin meet")
         .attr("viewBox", "0 0 " + window.innerWidth + " " + window.innerHeight)
         .classed("svg-content", true)
-        .datum({ data: parsedData, statLine: statLine, title: title, lineColor: lineColor })
+        .datum(chartData)
         .call(window.chart);
 }
 
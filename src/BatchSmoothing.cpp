@@ -0,0 +1,50 @@
+#include "BatchSmoothing.h"
+
+#include "ParallelUtils.h"
+#include "SmoothingFilters.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Estimated element operations worth one task; cheaper columns are grouped
+    constexpr double kMinimumTaskCost = 1 << 22;
+}
+
+void smoothColumns(
+    const float* x,
+    const float* columns,
+    std::size_t count,
+    std::size_t numColumns,
+    NormalizationType normalization,
+    SmoothingType smoothing,
+    const SmoothingParameters& parameters,
+    std::vector<std::shared_ptr<const LineSeries>>& smoothed,
+    const CancellationToken& cancellation)
+{
+    smoothed.assign(numColumns, nullptr);
+    if (numColumns == 0 || count == 0)
+        return;
+
+    // Every column costs the same, so the estimate only decides how many columns share a task
+    const double columnCost = std::max(smoothingCost(smoothing, count, parameters), 1.0);
+    const auto columnsPerTask = static_cast<std::size_t>(std::ceil(kMinimumTaskCost / columnCost));
+
+    parallelForChunks(numColumns, parallelChunkCount(numColumns, columnsPerTask), [&](std::size_t, std::size_t begin, std::size_t end) {
+        LineSeries input(count);
+        SmoothingWorkspace workspace;
+        std::copy_n(x, count, input.xData());
+
+        for (std::size_t column = begin; column < end && !cancellation.isCancelled(); ++column) {
+            applyColumnNormalization(columns + column * count, count, normalization, input.yData());
+
+            auto output = std::make_shared<LineSeries>();
+            applySmoothing(input, smoothing, parameters, *output, &workspace);
+            smoothed[column] = std::move(output);
+        }
+        });
+
+    if (cancellation.isCancelled())
+        smoothed.clear();
+}
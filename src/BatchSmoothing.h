@@ -0,0 +1,40 @@
+#pragma once
+
+#include "CancellationToken.h"
+#include "LinePlotUtils.h"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * Normalize and smooth many Y columns against one shared X
+ *
+ * \p columns is a column-major block of \p numColumns columns of \p count values,
+ * already in the order of \p x. \p x is normalized once by the caller, the main
+ * series' normalized X serves; every column gets the Y normalization of its own
+ * values and then the same filter as the main series. Columns are split into chunks sized by the
+ * filter's cost estimate and the chunks run in parallel on the global thread
+ * pool; a chunk reuses one input series and one smoothing workspace for all of
+ * its columns.
+ *
+ * @param x Shared, already normalized X values, sorted as the columns
+ * @param columns Column-major Y values
+ * @param count Number of values per column
+ * @param numColumns Number of columns
+ * @param normalization Normalization applied to every column before smoothing
+ * @param smoothing Filter applied to every column
+ * @param parameters Filter settings
+ * @param smoothed Receives one series per column, in column order; left empty when cancelled
+ * @param cancellation Checked between columns
+ */
+void smoothColumns(
+    const float* x,
+    const float* columns,
+    std::size_t count,
+    std::size_t numColumns,
+    NormalizationType normalization,
+    SmoothingType smoothing,
+    const SmoothingParameters& parameters,
+    std::vector<std::shared_ptr<const LineSeries>>& smoothed,
+    const CancellationToken& cancellation);
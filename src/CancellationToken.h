@@ -0,0 +1,14 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+// Cooperative cancellation flag shared between the GUI thread and a background pipeline run
+class CancellationToken {
+public:
+    CancellationToken() : _cancelled(std::make_shared<std::atomic_bool>(false)) {}
+    void cancel() const { _cancelled->store(true, std::memory_order_relaxed); }
+    bool isCancelled() const { return _cancelled->load(std::memory_order_relaxed); }
+private:
+    std::shared_ptr<std::atomic_bool> _cancelled;
+};
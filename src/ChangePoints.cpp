@@ -0,0 +1,120 @@
+#include "ChangePoints.h"
+
+#include "ParallelUtils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+std::vector<std::size_t> detectChangePoints(const LineSeries& data, ChangePointCost cost, float penalty, const CancellationToken& cancellation)
+{
+    std::vector<std::size_t> changePoints;
+    const std::size_t n = data.size();
+    if (cost == ChangePointCost::None || n < 4)
+        return changePoints;
+
+    // Block sums of the centered values, centering keeps the sums of squares from cancelling
+    const float* y = data.yData();
+    const double center = y[n / 2];
+    const std::size_t numBlocks = std::min(n, kMaxChangePointBlocks);
+    std::vector<double> blockSums(numBlocks);
+    std::vector<double> blockSquares(numBlocks);
+    const std::size_t numChunks = parallelChunkCount(numBlocks, 64);
+    std::vector<double> chunkDifferences(numChunks, 0.0);
+    parallelForChunks(numBlocks, numChunks, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+        for (std::size_t block = begin; block < end; ++block) {
+            double sum = 0.0;
+            double squares = 0.0;
+            for (std::size_t i = parallelChunkBegin(n, numBlocks, block); i < parallelChunkBegin(n, numBlocks, block + 1); ++i) {
+                const double value = static_cast<double>(y[i]) - center;
+                sum += value;
+                squares += value * value;
+            }
+            blockSums[block] = sum;
+            blockSquares[block] = squares;
+        }
+
+        double differences = 0.0;
+        const std::size_t last = std::min(parallelChunkBegin(n, numBlocks, end), n - 1);
+        for (std::size_t i = parallelChunkBegin(n, numBlocks, begin); i < last; ++i) {
+            const double difference = static_cast<double>(y[i + 1]) - static_cast<double>(y[i]);
+            differences += difference * difference;
+        }
+        chunkDifferences[chunk] = differences;
+        });
+
+    // Noise variance from the differences of neighbors, which only see a level shift once
+    double differences = 0.0;
+    for (const double value : chunkDifferences)
+        differences += value;
+    const double noiseVariance = differences / (2.0 * static_cast<double>(n - 1));
+    if (!(noiseVariance > 0.0))
+        return changePoints;
+
+    std::vector<double> prefixSums(numBlocks + 1, 0.0);
+    std::vector<double> prefixSquares(numBlocks + 1, 0.0);
+    std::vector<std::size_t> prefixCounts(numBlocks + 1, 0);
+    for (std::size_t block = 0; block < numBlocks; ++block) {
+        prefixSums[block + 1] = prefixSums[block] + blockSums[block];
+        prefixSquares[block + 1] = prefixSquares[block] + blockSquares[block];
+        prefixCounts[block + 1] = parallelChunkBegin(n, numBlocks, block + 1);
+    }
+
+    // A segment with zero variance would have unbounded likelihood, so the variance is floored
+    const double varianceFloor = 1e-6 * noiseVariance;
+    const auto segmentCost = [&](std::size_t begin, std::size_t end) {
+        const double count = static_cast<double>(prefixCounts[end] - prefixCounts[begin]);
+        const double sum = prefixSums[end] - prefixSums[begin];
+        const double deviations = std::max(prefixSquares[end] - prefixSquares[begin] - sum * sum / count, 0.0);
+        if (cost == ChangePointCost::Mean)
+            return deviations / noiseVariance;
+        return count * std::log(std::max(deviations / count, varianceFloor));
+        };
+
+    // Short segments fit noise, the variance of two points can be almost zero. Pooled blocks that
+    // straddle a change should join a neighbor rather than form a segment of their own
+    const std::size_t pointsPerBlock = n / numBlocks;
+    const std::size_t minBlocks = std::max<std::size_t>((kMinChangePointSegment + pointsPerBlock - 1) / pointsPerBlock, pointsPerBlock > 1 ? 2 : 1);
+    if (numBlocks < 2 * minBlocks)
+        return changePoints;
+    const double changePenalty = static_cast<double>(penalty) * std::log(static_cast<double>(n));
+
+    // best[t] is the optimal cost of the first t blocks, previous[t] where its last segment starts
+    std::vector<double> best(numBlocks + 1, std::numeric_limits<double>::infinity());
+    std::vector<std::uint32_t> previous(numBlocks + 1, 0);
+    best[0] = -changePenalty;
+
+    std::vector<std::uint32_t> candidates{ 0 };
+    std::vector<std::uint32_t> kept;
+    std::vector<double> candidateCosts;
+    for (std::size_t end = minBlocks; end <= numBlocks; ++end) {
+        if ((end & 255) == 0 && cancellation.isCancelled())
+            return changePoints;
+
+        if (end >= 2 * minBlocks)
+            candidates.push_back(static_cast<std::uint32_t>(end - minBlocks));
+
+        candidateCosts.resize(candidates.size());
+        for (std::size_t k = 0; k < candidates.size(); ++k) {
+            candidateCosts[k] = best[candidates[k]] + segmentCost(candidates[k], end);
+            if (candidateCosts[k] + changePenalty < best[end]) {
+                best[end] = candidateCosts[k] + changePenalty;
+                previous[end] = candidates[k];
+            }
+        }
+
+        // PELT pruning: a split that is already worse than the optimum can never become optimal later
+        kept.clear();
+        for (std::size_t k = 0; k < candidates.size(); ++k) {
+            if (candidateCosts[k] <= best[end])
+                kept.push_back(candidates[k]);
+        }
+        candidates.swap(kept);
+    }
+
+    for (std::size_t end = numBlocks; previous[end] > 0; end = previous[end])
+        changePoints.push_back(prefixCounts[previous[end]]);
+    std::reverse(changePoints.begin(), changePoints.end());
+    return changePoints;
+}
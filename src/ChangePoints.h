@@ -0,0 +1,38 @@
+#pragma once
+
+#include "CancellationToken.h"
+#include "LinePlotViewPlugin.h" // for ChangePointCost
+#include "../libs/LineChartLib/LineSeries.h"
+
+#include <cstddef>
+#include <vector>
+
+// Segmentations are searched over at most this many blocks of consecutive points, finer than any plot is wide
+constexpr std::size_t kMaxChangePointBlocks = std::size_t(1) << 13;
+
+// Fewest points in a segment
+constexpr std::size_t kMinChangePointSegment = 8;
+
+/**
+ * Change points in the Y values of \p data by PELT (Killick, Fearnhead and Eckley)
+ *
+ * Finds the segmentation minimizing the summed segment costs plus
+ * penalty * log(n) per change. Costs are twice the negative log-likelihood of a
+ * normal model: ChangePointCost::Mean lets the mean change under one common
+ * variance, which is estimated from the point-to-point differences so level
+ * shifts do not inflate it; ChangePointCost::MeanVariance lets both change.
+ * Every segment cost is O(1) from prefix sums of y and y^2, and PELT drops
+ * split candidates that can no longer be optimal, which keeps the search near
+ * linear when the changes are spread over the series.
+ *
+ * Long series are summarized into kMaxChangePointBlocks blocks in one parallel
+ * pass first. Costs stay exact, only the change points are restricted to block
+ * boundaries, and the worst case of PELT, a series without changes, stays bounded.
+ *
+ * @param data Series in the order it is drawn
+ * @param cost Segment cost, ChangePointCost::None detects nothing
+ * @param penalty Cost of a change in units of log(n)
+ * @param cancellation Checked while searching
+ * @return Index of the first point of every segment after the first, ascending; empty when cancelled
+ */
+std::vector<std::size_t> detectChangePoints(const LineSeries& data, ChangePointCost cost, float penalty, const CancellationToken& cancellation);
@@ -0,0 +1,116 @@
+#include "ChartDataSchemeHandler.h"
+
+#include <QBuffer>
+#include <QDebug>
+#include <QMutexLocker>
+#include <QStringList>
+#include <QUrl>
+#include <QWebEngineProfile>
+#include <QWebEngineUrlRequestJob>
+#include <QWebEngineUrlScheme>
+
+namespace
+{
+    // Reply device that keeps the memory it reads from alive until the engine is done with it
+    class OwningBuffer : public QBuffer
+    {
+    public:
+        explicit OwningBuffer(const ChartDataSchemeHandler::Buffer& buffer) :
+            _owner(buffer.owner)
+        {
+            setData(buffer.bytes);
+        }
+
+    private:
+        std::shared_ptr<const void> _owner;
+    };
+}
+
+const QByteArray ChartDataSchemeHandler::schemeName = QByteArrayLiteral("lineplotdata");
+
+void ChartDataSchemeHandler::registerScheme()
+{
+    if (!QWebEngineUrlScheme::schemeByName(schemeName).name().isEmpty())
+        return;
+
+    QWebEngineUrlScheme scheme(schemeName);
+    scheme.setSyntax(QWebEngineUrlScheme::Syntax::Path);
+
+    auto flags = QWebEngineUrlScheme::LocalScheme | QWebEngineUrlScheme::LocalAccessAllowed | QWebEngineUrlScheme::CorsEnabled;
+#if QT_VERSION >= QT_VERSION_CHECK(6, 6, 0)
+    flags |= QWebEngineUrlScheme::FetchApiAllowed;
+#endif
+    scheme.setFlags(flags);
+
+    QWebEngineUrlScheme::registerScheme(scheme);
+}
+
+ChartDataSchemeHandler* ChartDataSchemeHandler::installOn(QWebEngineProfile* profile)
+{
+    if (profile == nullptr)
+        return nullptr;
+
+    if (const auto* installed = profile->urlSchemeHandler(schemeName))
+        return qobject_cast<ChartDataSchemeHandler*>(const_cast<QWebEngineUrlSchemeHandler*>(installed));
+
+    auto* handler = new ChartDataSchemeHandler(profile);
+    profile->installUrlSchemeHandler(schemeName, handler);
+    return handler;
+}
+
+QString ChartDataSchemeHandler::bufferUrl(const QString& channel, quint64 version, const QString& name)
+{
+    return QString("%1:%2/%3/%4").arg(QString::fromLatin1(schemeName), channel, QString::number(version), name);
+}
+
+ChartDataSchemeHandler::ChartDataSchemeHandler(QObject* parent) :
+    QWebEngineUrlSchemeHandler(parent)
+{
+}
+
+void ChartDataSchemeHandler::publish(const QString& channel, quint64 version, Buffers buffers)
+{
+    QMutexLocker locker(&_mutex);
+
+    auto& entry = _channels[channel];
+    entry.version = version;
+    entry.buffers = std::move(buffers);
+}
+
+void ChartDataSchemeHandler::release(const QString& channel)
+{
+    QMutexLocker locker(&_mutex);
+
+    _channels.remove(channel);
+}
+
+void ChartDataSchemeHandler::requestStarted(QWebEngineUrlRequestJob* job)
+{
+    // Path is <channel>/<version>/<name>
+    const QStringList parts = job->requestUrl().path().split('/', Qt::SkipEmptyParts);
+    if (parts.size() != 3) {
+        job->fail(QWebEngineUrlRequestJob::UrlInvalid);
+        return;
+    }
+
+    Buffer buffer;
+    {
+        QMutexLocker locker(&_mutex);
+
+        const auto channel = _channels.constFind(parts[0]);
+        if (channel == _channels.constEnd() || QString::number(channel->version) != parts[1] || !channel->buffers.contains(parts[2])) {
+            job->fail(QWebEngineUrlRequestJob::UrlNotFound);
+            return;
+        }
+
+        buffer = channel->buffers.value(parts[2]);
+    }
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 6, 0)
+    job->setAdditionalResponseHeaders({ { QByteArrayLiteral("Access-Control-Allow-Origin"), QByteArrayLiteral("*") } });
+#endif
+
+    auto* device = new OwningBuffer(buffer);
+    connect(job, &QObject::destroyed, device, &QObject::deleteLater);
+    job->reply(QByteArrayLiteral("application/octet-stream"), device);
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QWebEngineUrlSchemeHandler>
+
+#include <memory>
+
+class QWebEngineProfile;
+
+// =============================================================================
+// ChartDataSchemeHandler
+// =============================================================================
+
+/**
+ * Serves chart series to the web page as raw binary buffers
+ *
+ * Buffers are published per channel (one per chart widget) under a version id and
+ * fetched by the page as ArrayBuffers from lineplotdata:<channel>/<version>/<name>.
+ * Requests for a superseded version fail, so the page never mixes two updates.
+ */
+class ChartDataSchemeHandler : public QWebEngineUrlSchemeHandler
+{
+    Q_OBJECT
+public:
+    /** A published buffer, \p owner keeps the memory behind \p bytes alive */
+    struct Buffer {
+        QByteArray                  bytes;
+        std::shared_ptr<const void> owner;
+    };
+
+    using Buffers = QHash<QString, Buffer>;
+
+    /** Name of the URL scheme */
+    static const QByteArray schemeName;
+
+    /** Register the scheme with the web engine, must happen before the first web engine class is created */
+    static void registerScheme();
+
+    /** Return the handler installed on \p profile, installing one when there is none yet */
+    static ChartDataSchemeHandler* installOn(QWebEngineProfile* profile);
+
+    /** URL under which the page finds buffer \p name of \p version on \p channel */
+    static QString bufferUrl(const QString& channel, quint64 version, const QString& name);
+
+    /** Replace the buffers of \p channel with \p buffers, published as \p version */
+    void publish(const QString& channel, quint64 version, Buffers buffers);
+
+    /** Drop the buffers of \p channel */
+    void release(const QString& channel);
+
+    void requestStarted(QWebEngineUrlRequestJob* job) override;
+
+private:
+    explicit ChartDataSchemeHandler(QObject* parent);
+
+    struct Channel {
+        quint64     version = 0;
+        Buffers     buffers;
+    };
+
+    QMutex                      _mutex;
+    QHash<QString, Channel>     _channels;
+};
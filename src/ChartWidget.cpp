@@ -2,7 +2,14 @@
 #include "LinePlotViewPlugin.h"
 
 #include <QDebug>
+#include <QResizeEvent>
 #include <QString>
+#include <QUuid>
+#include <QWebEnginePage>
+#include <QWebEngineProfile>
+
+#include <cstdint>
+#include <limits>
 
 using namespace mv;
 using namespace mv::gui;
@@ -42,7 +49,10 @@ void ChartCommObject::js_qt_passSelectionToQt(const QVariantList& data){
 
 ChartWidget::ChartWidget(LinePlotViewPlugin* viewJSPlugin):
     _viewJSPlugin(viewJSPlugin),
-    _comObject()
+    _comObject(),
+    _dataHandler(nullptr),
+    _dataChannel(QUuid::createUuid().toString(QUuid::Id128)),
+    _dataVersion(0)
 {
     // For more info on drag&drop behavior, see the LineViewPlugin project
     setAcceptDrops(true);
@@ -55,6 +65,95 @@ ChartWidget::ChartWidget(LinePlotViewPlugin* viewJSPlugin):
     init(&_comObject);
 
     layout()->setContentsMargins(0, 0, 0, 0);
+
+    _dataHandler = ChartDataSchemeHandler::installOn(getPage()->profile());
+    if (_dataHandler.isNull())
+        qWarning() << "ChartWidget: Could not install the chart data scheme handler";
+}
+
+ChartWidget::~ChartWidget()
+{
+    if (_dataHandler)
+        _dataHandler->release(_dataChannel);
+}
+
+void ChartWidget::resizeEvent(QResizeEvent* event)
+{
+    mv::gui::WebWidget::resizeEvent(event);
+
+    if (event->size().width() != event->oldSize().width())
+        emit plotWidthChanged(qRound(event->size().width() * devicePixelRatioF()));
+}
+
+namespace
+{
+    // Narrow category codes to the smallest unsigned type that still has room for the "no category" marker
+    template <typename T>
+    QByteArray encodeCategoryCodes(const LineCategories& categories)
+    {
+        QByteArray bytes(static_cast<qsizetype>(categories.size() * sizeof(T)), Qt::Uninitialized);
+        auto* codes = reinterpret_cast<T*>(bytes.data());
+        const auto* source = categories.codeData();
+        for (std::size_t i = 0; i < categories.size(); ++i)
+            codes[i] = source[i] == LineCategories::NoCategory ? std::numeric_limits<T>::max() : static_cast<T>(source[i]);
+        return bytes;
+    }
+}
+
+void ChartWidget::setSeries(const std::shared_ptr<const LineSeries>& points,
+    const std::shared_ptr<const LineCategories>& categories,
+    const QVariantMap& statLine,
+    const QString& title,
+    const QString& xAxisName,
+    const QString& yAxisName)
+{
+    const auto version = ++_dataVersion;
+    const std::size_t count = points ? points->size() : 0;
+
+    QVariantMap metadata;
+    metadata["version"] = QString::number(version);
+    metadata["count"] = static_cast<qulonglong>(count);
+    metadata["title"] = title;
+    metadata["xAxisName"] = xAxisName;
+    metadata["yAxisName"] = yAxisName;
+    metadata["lineColor"] = "#1f77b4";
+    if (!statLine.isEmpty())
+        metadata["statLine"] = statLine;
+
+    if (count > 0 && _dataHandler) {
+        ChartDataSchemeHandler::Buffers buffers;
+        const auto bytesOf = [count](const float* data) {
+            return QByteArray::fromRawData(reinterpret_cast<const char*>(data), static_cast<qsizetype>(count * sizeof(float)));
+            };
+        buffers.insert("x", { bytesOf(points->xData()), points });
+        buffers.insert("y", { bytesOf(points->yData()), points });
+
+        QVariantMap urls;
+        urls["x"] = ChartDataSchemeHandler::bufferUrl(_dataChannel, version, "x");
+        urls["y"] = ChartDataSchemeHandler::bufferUrl(_dataChannel, version, "y");
+
+        if (categories && categories->size() == count) {
+            const bool narrowCodes = categories->paletteSize() < std::numeric_limits<std::uint16_t>::max();
+            buffers.insert("codes", { narrowCodes ? encodeCategoryCodes<std::uint16_t>(*categories) : encodeCategoryCodes<std::uint32_t>(*categories), nullptr });
+            urls["codes"] = ChartDataSchemeHandler::bufferUrl(_dataChannel, version, "codes");
+            metadata["codeType"] = narrowCodes ? "uint16" : "uint32";
+
+            // The palette travels once, points only reference it by code
+            QVariantList palette;
+            palette.reserve(categories->paletteSize());
+            for (int code = 0; code < categories->paletteSize(); ++code)
+                palette.append(QVariant(QVariantList{ categories->paletteColor(code).name(), categories->paletteLabel(code) }));
+            metadata["palette"] = palette;
+        }
+
+        metadata["buffers"] = urls;
+        _dataHandler->publish(_dataChannel, version, std::move(buffers));
+    }
+    else if (_dataHandler) {
+        _dataHandler->release(_dataChannel);
+    }
+
+    emit _comObject.qt_js_setChartBuffersInJS(metadata);
 }
 
 void ChartWidget::initWebPage()
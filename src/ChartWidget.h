@@ -2,9 +2,16 @@
 
 #include "widgets/WebWidget.h"
 
+#include "ChartDataSchemeHandler.h"
+#include "../libs/LineChartLib/LineSeries.h"
+#include "../libs/LineChartLib/LineCategories.h"
+
+#include <QPointer>
 #include <QVariantList>
 #include <QVariantMap>
 
+#include <memory>
+
 Q_DECLARE_METATYPE(QVariantList)
 Q_DECLARE_METATYPE(QVariantMap)
 
@@ -26,6 +33,10 @@ signals:
     // But other communication like messaging selection IDs can be handled the same
     void qt_js_setDataAndPlotInJS(const QVariantMap& data);
 
+    // Announces new binary chart buffers: carries the buffer URLs, the version id and the chart labels,
+    // the page fetches the series itself from the ChartDataSchemeHandler
+    void qt_js_setChartBuffersInJS(const QVariantMap& metadata);
+
     // Signals Qt internal
     // Used to inform the plugin about new selection: the plugin class then updates ManiVault's core
     void passSelectionToCore(const std::vector<unsigned int>& selectionIDs);
@@ -49,9 +60,30 @@ class ChartWidget : public mv::gui::WebWidget
     Q_OBJECT
 public:
     ChartWidget(LinePlotViewPlugin* viewJSPlugin);
+    ~ChartWidget() override;
 
     ChartCommObject& getCommunicationObject() { return _comObject; };
 
+    /**
+     * Publish the series as binary buffers and notify the page
+     * X and Y are served as Float32 without copying, category codes as Uint16 (Uint32 for very large palettes)
+     * @param points Series drawn as the main line, must not be modified afterwards
+     * @param categories Per-point categories of \p points, may be empty
+     */
+    void setSeries(const std::shared_ptr<const LineSeries>& points,
+        const std::shared_ptr<const LineCategories>& categories,
+        const QVariantMap& statLine,
+        const QString& title,
+        const QString& xAxisName,
+        const QString& yAxisName);
+
+signals:
+    /** Emitted when the width of the chart changes, in device pixels */
+    void plotWidthChanged(int width);
+
+protected:
+    void resizeEvent(QResizeEvent* event) override;
+
 private slots:
     /** Is invoked when the js side calls js_available of the mv::gui::WebCommunicationObject (ChartCommObject) 
         js_available emits notifyJsBridgeIsAvailable, which is conencted to this slot in WebWidget.cpp*/
@@ -60,4 +92,7 @@ private slots:
 private:
     LinePlotViewPlugin*  _viewJSPlugin;    // Pointer to the main plugin class
     ChartCommObject       _comObject;       // Communication Object between Qt (cpp) and JavaScript
+    QPointer<ChartDataSchemeHandler> _dataHandler;  // Serves the binary series, shared by all chart widgets of a profile
+    QString               _dataChannel;     // Identifies the buffers of this widget in the handler
+    quint64               _dataVersion;     // Version of the last published buffers
 };
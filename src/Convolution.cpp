@@ -0,0 +1,215 @@
+#include "Convolution.h"
+
+#include "Fft.h"
+#include "ParallelUtils.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+    // Kernels this short are always filtered directly, the FFT cannot win there
+    constexpr std::size_t kMinimumFftWidth = 32;
+    constexpr std::size_t kMaximumFftSize = std::size_t(1) << 20;
+
+    // Measured seconds per weight and output of the direct method and per
+    // size * log2(size) of one transform; the paired segment costs two of those
+    struct ConvolutionCosts {
+        double  directTap = 0.0;
+        double  fftPoint = 0.0;
+    };
+
+    void applyFirValidDirect(const float* signal, std::size_t count, const float* weights, std::size_t width, float* out)
+    {
+        constexpr std::size_t kBlockSize = 1024;
+        const std::size_t outCount = count - width + 1;
+
+        // Accumulates blockSize outputs starting at blockBegin; a compile-time block size lets the inner loop vectorize
+        const auto accumulate = [signal, weights, width](std::size_t blockBegin, auto blockSize, float* accumulator) {
+            std::fill_n(accumulator, blockSize, 0.0f);
+            for (std::size_t j = 0; j < width; ++j) {
+                const float weight = weights[j];
+                const float* samples = signal + blockBegin + j;
+                for (std::size_t i = 0; i < blockSize; ++i)
+                    accumulator[i] += weight * samples[i];
+            }
+            };
+
+        parallelForChunks(outCount, parallelChunkCount(outCount, 1 << 15), [&](std::size_t, std::size_t begin, std::size_t end) {
+            alignas(64) std::array<float, kBlockSize> accumulator;
+            std::size_t blockBegin = begin;
+            for (; blockBegin + kBlockSize <= end; blockBegin += kBlockSize) {
+                accumulate(blockBegin, std::integral_constant<std::size_t, kBlockSize>(), accumulator.data());
+                std::copy_n(accumulator.data(), kBlockSize, out + blockBegin);
+            }
+            if (blockBegin < end) {
+                accumulate(blockBegin, end - blockBegin, accumulator.data());
+                std::copy_n(accumulator.data(), end - blockBegin, out + blockBegin);
+            }
+            });
+    }
+
+    void applyFirValidFft(const float* signal, std::size_t count, const float* weights, std::size_t width, float* out, std::size_t fftSize)
+    {
+        using Complex = FftPlan::Complex;
+
+        const FftPlan plan(fftSize);
+        const std::size_t outCount = count - width + 1;
+        const std::size_t step = fftSize - width + 1;
+        const std::size_t segments = (outCount + step - 1) / step;
+        const std::size_t pairs = (segments + 1) / 2;
+
+        // The correlation with the weights is a convolution with the reversed weights
+        std::vector<Complex> response(fftSize);
+        for (std::size_t j = 0; j < width; ++j)
+            response[j] = weights[width - 1 - j];
+        plan.forward(response.data());
+
+        // Segment s reads signal[s * step, s * step + fftSize); the circular convolution is
+        // exact from index width - 1 on, which holds the step outputs starting at s * step
+        const auto loadSegment = [&](std::size_t segment, std::vector<Complex>& buffer, bool imaginary) {
+            const std::size_t begin = segment * step;
+            const std::size_t available = begin < count ? std::min(fftSize, count - begin) : 0;
+            for (std::size_t i = 0; i < fftSize; ++i) {
+                const double sample = i < available ? signal[begin + i] : 0.0;
+                buffer[i] = imaginary ? Complex(buffer[i].real(), sample) : Complex(sample, 0.0);
+            }
+            };
+
+        const auto storeSegment = [&](std::size_t segment, const std::vector<Complex>& buffer, bool imaginary) {
+            const std::size_t begin = segment * step;
+            const std::size_t length = std::min(step, outCount - begin);
+            for (std::size_t i = 0; i < length; ++i) {
+                const Complex& value = buffer[width - 1 + i];
+                out[begin + i] = static_cast<float>(imaginary ? value.imag() : value.real());
+            }
+            };
+
+        // The weights are real, so two segments filter at once as real and imaginary part of one transform
+        parallelForChunks(pairs, parallelChunkCount(pairs, std::max<std::size_t>(1, (1 << 16) / fftSize)), [&](std::size_t, std::size_t begin, std::size_t end) {
+            std::vector<Complex> buffer(fftSize);
+            for (std::size_t pair = begin; pair < end; ++pair) {
+                const std::size_t first = 2 * pair;
+                const bool hasSecond = first + 1 < segments;
+
+                loadSegment(first, buffer, false);
+                if (hasSecond)
+                    loadSegment(first + 1, buffer, true);
+
+                plan.forward(buffer.data());
+                for (std::size_t k = 0; k < fftSize; ++k) {
+                    const double re = buffer[k].real() * response[k].real() - buffer[k].imag() * response[k].imag();
+                    const double im = buffer[k].real() * response[k].imag() + buffer[k].imag() * response[k].real();
+                    buffer[k] = Complex(re, im);
+                }
+                plan.inverse(buffer.data());
+
+                storeSegment(first, buffer, false);
+                if (hasSecond)
+                    storeSegment(first + 1, buffer, true);
+            }
+            });
+    }
+
+    // Times both methods single-threaded on a problem small enough to stay in cache
+    ConvolutionCosts measureCosts()
+    {
+        using Clock = std::chrono::steady_clock;
+
+        const auto bestOf = [](int runs, auto&& work) {
+            double best = std::numeric_limits<double>::max();
+            for (int run = 0; run < runs; ++run) {
+                const auto start = Clock::now();
+                work();
+                best = std::min(best, std::chrono::duration<double>(Clock::now() - start).count());
+            }
+            return best;
+            };
+
+        constexpr std::size_t kWidth = 64;
+        constexpr std::size_t kOutputs = 1 << 14;
+        std::vector<float> signal(kOutputs + kWidth - 1), weights(kWidth, 1.0f / kWidth), out(kOutputs);
+        for (std::size_t i = 0; i < signal.size(); ++i)
+            signal[i] = static_cast<float>(i % 97);
+
+        constexpr std::size_t kFftSize = 1 << 12;
+        const FftPlan plan(kFftSize);
+        std::vector<FftPlan::Complex> buffer(kFftSize, FftPlan::Complex(1.0, 0.0));
+
+        ConvolutionCosts costs;
+        costs.directTap = bestOf(3, [&]() { applyFirValidDirect(signal.data(), signal.size(), weights.data(), kWidth, out.data()); })
+            / static_cast<double>(kOutputs * kWidth);
+        costs.fftPoint = bestOf(3, [&]() { plan.forward(buffer.data()); plan.inverse(buffer.data()); })
+            / (2.0 * kFftSize * std::log2(static_cast<double>(kFftSize)));
+        return costs;
+    }
+
+    const ConvolutionCosts& convolutionCosts()
+    {
+        static std::once_flag calibrated;
+        static ConvolutionCosts costs;
+        std::call_once(calibrated, []() { costs = measureCosts(); });
+        return costs;
+    }
+
+    double fftCost(std::size_t outCount, std::size_t width, std::size_t fftSize, const ConvolutionCosts& costs)
+    {
+        const std::size_t step = fftSize - width + 1;
+        const double pairs = std::ceil(static_cast<double>((outCount + step - 1) / step) / 2.0);
+        const double size = static_cast<double>(fftSize);
+
+        // Forward and inverse transform plus the spectrum product, counted as one more pass
+        return pairs * costs.fftPoint * size * (2.0 * std::log2(size) + 1.0);
+    }
+
+    // Cheapest transform size for the problem; larger transforms waste less on the overlap but cost more per point
+    std::size_t bestFftSize(std::size_t count, std::size_t width, const ConvolutionCosts& costs, double& bestCost)
+    {
+        const std::size_t outCount = count - width + 1;
+        const std::size_t smallest = std::bit_ceil(2 * width);
+        const std::size_t largest = std::max(smallest, std::min(kMaximumFftSize, std::bit_ceil(count)));
+
+        std::size_t bestSize = smallest;
+        bestCost = fftCost(outCount, width, smallest, costs);
+        for (std::size_t fftSize = smallest * 2; fftSize <= largest; fftSize *= 2) {
+            const double cost = fftCost(outCount, width, fftSize, costs);
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestSize = fftSize;
+            }
+        }
+        return bestSize;
+    }
+}
+
+void applyFirValid(const float* signal, std::size_t count, const float* weights, std::size_t width, float* out, ConvolutionMethod method)
+{
+    if (width == 0 || count < width)
+        return;
+
+    if (method == ConvolutionMethod::Auto && width < kMinimumFftWidth)
+        method = ConvolutionMethod::Direct;
+
+    std::size_t fftSize = 0;
+    if (method != ConvolutionMethod::Direct) {
+        const ConvolutionCosts& costs = convolutionCosts();
+        double cost = 0.0;
+        fftSize = bestFftSize(count, width, costs, cost);
+
+        const double directCost = costs.directTap * static_cast<double>(count - width + 1) * static_cast<double>(width);
+        if (method == ConvolutionMethod::Auto && directCost <= cost)
+            fftSize = 0;
+    }
+
+    if (fftSize == 0)
+        applyFirValidDirect(signal, count, weights, width, out);
+    else
+        applyFirValidFft(signal, count, weights, width, out, fftSize);
+}
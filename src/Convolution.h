@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+
+// How applyFirValid evaluates the filter
+enum class ConvolutionMethod {
+    Auto,   // Cheapest of the two according to the calibrated cost model
+    Direct, // Multiply-add per output and weight, O(count * width)
+    Fft     // Overlap-save block FFT, O(count * log(width))
+};
+
+/**
+ * FIR filtering over the fully covered part of a signal
+ *
+ * Writes out[i] = sum_j weights[j] * signal[i + j] for i in [0, count - width].
+ *
+ * The direct method accumulates outputs a block at a time with the weight loop
+ * outermost, so the inner loop is a plain multiply-add over contiguous memory
+ * that the compiler vectorizes. The FFT method filters overlapping segments in
+ * the frequency domain, two real segments per complex transform. Both process
+ * blocks in parallel.
+ *
+ * Auto compares the estimated cost of both methods. The per-operation costs are
+ * measured once per process on a small problem, so the crossover follows the
+ * machine rather than a fixed kernel width.
+ *
+ * @param signal Input samples
+ * @param count Number of input samples
+ * @param weights Filter weights
+ * @param width Number of weights
+ * @param out Receives count - width + 1 samples, nothing when count < width
+ * @param method Evaluation method
+ */
+void applyFirValid(const float* signal, std::size_t count, const float* weights, std::size_t width, float* out,
+    ConvolutionMethod method = ConvolutionMethod::Auto);
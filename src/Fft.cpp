@@ -0,0 +1,63 @@
+#include "Fft.h"
+
+#include <bit>
+#include <cmath>
+#include <numbers>
+#include <utility>
+
+FftPlan::FftPlan(std::size_t size) :
+    _size(size),
+    _bitReverse(size),
+    _twiddles(size / 2)
+{
+    const int bits = size > 1 ? std::countr_zero(size) : 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        std::uint32_t reversed = 0;
+        for (int b = 0; b < bits; ++b)
+            reversed |= ((i >> b) & 1u) << (bits - 1 - b);
+        _bitReverse[i] = reversed;
+    }
+
+    for (std::size_t k = 0; k < size / 2; ++k) {
+        const double angle = -2.0 * std::numbers::pi * static_cast<double>(k) / static_cast<double>(size);
+        _twiddles[k] = Complex(std::cos(angle), std::sin(angle));
+    }
+}
+
+void FftPlan::inverse(Complex* data) const
+{
+    transform(data, true);
+    const double scale = 1.0 / static_cast<double>(_size);
+    for (std::size_t i = 0; i < _size; ++i)
+        data[i] *= scale;
+}
+
+void FftPlan::transform(Complex* data, bool inverse) const
+{
+    for (std::size_t i = 0; i < _size; ++i) {
+        if (i < _bitReverse[i])
+            std::swap(data[i], data[_bitReverse[i]]);
+    }
+
+    // Butterflies are written out on the real and imaginary parts; std::complex
+    // multiplication would add NaN/infinity recovery to every product
+    const double sign = inverse ? -1.0 : 1.0;
+    for (std::size_t length = 2; length <= _size; length *= 2) {
+        const std::size_t half = length / 2;
+        const std::size_t stride = _size / length;
+        for (std::size_t start = 0; start < _size; start += length) {
+            Complex* a = data + start;
+            Complex* b = a + half;
+            for (std::size_t k = 0; k < half; ++k) {
+                const double wr = _twiddles[k * stride].real();
+                const double wi = sign * _twiddles[k * stride].imag();
+                const double vr = b[k].real() * wr - b[k].imag() * wi;
+                const double vi = b[k].real() * wi + b[k].imag() * wr;
+                const double ur = a[k].real();
+                const double ui = a[k].imag();
+                a[k] = Complex(ur + vr, ui + vi);
+                b[k] = Complex(ur - vr, ui - vi);
+            }
+        }
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Precomputed in-place complex FFT of a fixed power-of-two size
+ *
+ * Iterative radix-2 decimation in time with tabulated twiddle factors and bit
+ * reversal, so a transform does no allocation and no trigonometry. A plan is
+ * immutable after construction and can be shared between threads.
+ */
+class FftPlan
+{
+public:
+    using Complex = std::complex<double>;
+
+    /** Plan transforms of \p size points, which must be a power of two */
+    explicit FftPlan(std::size_t size);
+
+    std::size_t size() const { return _size; }
+
+    /** Forward transform of size() points in place */
+    void forward(Complex* data) const { transform(data, false); }
+
+    /** Inverse transform of size() points in place, scaled by 1 / size() */
+    void inverse(Complex* data) const;
+
+private:
+    void transform(Complex* data, bool inverse) const;
+
+private:
+    std::size_t                 _size;
+    std::vector<std::uint32_t>  _bitReverse;    // Partner of every index in the input permutation
+    std::vector<Complex>        _twiddles;      // exp(-2 pi i k / size) for k < size / 2
+};
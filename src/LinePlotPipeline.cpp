@@ -0,0 +1,232 @@
+#include "LinePlotPipeline.h"
+
+#include <QDebug>
+#include <QMutexLocker>
+
+#include <algorithm>
+
+template <typename Key>
+bool LinePlotPipeline::needsUpdate(StageState<Key>& stage, const Key& key)
+{
+    if (stage.key && *stage.key == key)
+        return false;
+
+    // The stage buffers are about to be overwritten, so the old key no longer describes them
+    stage.key.reset();
+    return true;
+}
+
+template <typename T>
+T& LinePlotPipeline::detach(std::shared_ptr<T>& buffer)
+{
+    // A buffer still referenced by a published result is left alone and replaced
+    if (!buffer || buffer.use_count() > 1)
+        buffer = std::make_shared<T>();
+    return *buffer;
+}
+
+template <typename Key>
+void LinePlotPipeline::commit(StageState<Key>& stage, const Key& key)
+{
+    stage.key = key;
+    stage.stamp = ++_stampCounter;
+}
+
+void LinePlotPipeline::clear()
+{
+    QMutexLocker locker(&_mutex);
+
+    _sortStage = {};
+    _robustStatisticsStage = {};
+    _normalizationStage = {};
+    _trendStage = {};
+    _changePointStage = {};
+    _aggregationStage = {};
+    _smoothingStage = {};
+    _splineStage = {};
+    _overlayStage = {};
+
+    _sortedData.clear();
+    _sortedCategories.reset();
+    _sortPermutation.clear();
+    _normalizedData.reset();
+    _robustStatistics = {};
+    _normalizedStatistics = {};
+    _statLine.clear();
+    _changePoints.clear();
+    _aggregatedData.reset();
+    _rangeLower.reset();
+    _rangeUpper.reset();
+    _smoothedData.reset();
+    _smoothingWorkspace = {};
+    _spline.clear();
+    _overlayColumns.clear();
+    _overlays.clear();
+}
+
+LinePlotResult LinePlotPipeline::run(const LinePlotRequest& request, const CancellationToken& cancellation)
+{
+    QMutexLocker locker(&_mutex);
+
+    LinePlotResult result;
+    result.generation = request.generation;
+
+    const auto cancelled = [&cancellation, &result]() -> bool {
+        result.cancelled = cancellation.isCancelled();
+        return result.cancelled;
+        };
+
+    if (cancelled())
+        return result;
+
+    // The columns were copied from the datasets on the GUI thread, the worker never reads the datasets
+    if (!request.source || request.source->data.isEmpty()) {
+        qCritical() << "LinePlotPipeline::run: Invalid input data";
+        return result;
+    }
+
+    // Sorting, straight from the shared columns; switching axes only changes which column is which
+    const SortKey sortKey{ request.source, request.switchAxes, request.sortAxisValue };
+    if (needsUpdate(_sortStage, sortKey)) {
+        sortDataAndCategories(request.source->data, request.source->categories, request.switchAxes,
+            _sortedData, detach(_sortedCategories), _sortPermutation, request.sortAxisValue);
+        if (cancelled())
+            return result;
+        commit(_sortStage, sortKey);
+    }
+
+    // Robust statistics, kept per series so switching between the robust modes does not rescan
+    const bool robust = request.normalization == NormalizationType::MedianMad || request.normalization == NormalizationType::QuantileClip;
+    if (robust && needsUpdate(_robustStatisticsStage, _sortStage.stamp)) {
+        _robustStatistics = computeSeriesRobustStatistics(_sortedData);
+        if (cancelled())
+            return result;
+        commit(_robustStatisticsStage, _sortStage.stamp);
+    }
+
+    // Normalization, the stat line only depends on its output
+    const NormalizationKey normalizationKey{ _sortStage.stamp, request.normalization };
+    if (needsUpdate(_normalizationStage, normalizationKey)) {
+        auto& normalizedData = detach(_normalizedData);
+        applyNormalization(_sortedData, request.normalization, normalizedData, &_normalizedStatistics, robust ? &_robustStatistics : nullptr);
+        if (cancelled())
+            return result;
+        commit(_normalizationStage, normalizationKey);
+    }
+
+    // Stat line; the two-means line and the least squares fit come from the statistics, Theil-Sen needs the points
+    const TrendKey trendKey{ _normalizationStage.stamp, request.statLineType };
+    if (request.showStatLine && needsUpdate(_trendStage, trendKey)) {
+        switch (request.statLineType) {
+        case StatLineType::TwoMeans:
+            _statLine = calculateStatLine(_normalizedStatistics);
+            break;
+        case StatLineType::LeastSquares:
+            _statLine = calculateTrendStatLine(fitLeastSquares(_normalizedStatistics), _normalizedStatistics, "Least squares");
+            break;
+        case StatLineType::TheilSen:
+            _statLine = calculateTrendStatLine(fitTheilSen(*_normalizedData, cancellation), _normalizedStatistics, "Theil-Sen");
+            break;
+        }
+        if (cancelled())
+            return result;
+        commit(_trendStage, trendKey);
+    }
+    const QVariantMap statLine = request.showStatLine ? _statLine : QVariantMap();
+
+    // Change points, marked halfway between the last point of a segment and the first of the next
+    const ChangePointKey changePointKey{ _normalizationStage.stamp, request.changePointCost, request.changePointPenalty };
+    if (needsUpdate(_changePointStage, changePointKey)) {
+        const auto changeIndices = detectChangePoints(*_normalizedData, request.changePointCost, request.changePointPenalty, cancellation);
+        if (cancelled())
+            return result;
+        _changePoints.clear();
+        for (const std::size_t index : changeIndices)
+            _changePoints.push_back(0.5f * (_normalizedData->x(index - 1) + _normalizedData->x(index)));
+        commit(_changePointStage, changePointKey);
+    }
+
+    // Grouping by X needs the groups to be contiguous, so it only applies while sorted by X
+    const bool aggregating = request.xAggregation != XAggregation::None && request.sortAxisValue != "Y";
+    if (aggregating) {
+        const AggregationKey aggregationKey{ _normalizationStage.stamp, request.xAggregation, std::max(request.xBinWidth, 0.0f) };
+        if (needsUpdate(_aggregationStage, aggregationKey)) {
+            aggregateByX(*_normalizedData, aggregationKey.aggregation, aggregationKey.binWidth,
+                detach(_aggregatedData), detach(_rangeLower), detach(_rangeUpper), cancellation);
+            if (cancelled())
+                return result;
+            commit(_aggregationStage, aggregationKey);
+        }
+    }
+
+    // The line is the normalized series, or its aggregate while grouping by X
+    const std::shared_ptr<LineSeries>& lineData = aggregating ? _aggregatedData : _normalizedData;
+    const quint64 lineStamp = aggregating ? _aggregationStage.stamp : _normalizationStage.stamp;
+
+    // Smoothing; the sample count only matters to resampling filters, so resizing the plot leaves the others alone
+    SmoothingKey smoothingKey{ lineStamp, request.smoothing, request.smoothingParameters };
+    if (!smoothingFilterReads(request.smoothing, SmoothingParameter::SampleCount))
+        smoothingKey.smoothingParameters.sampleCount = 0;
+    if (needsUpdate(_smoothingStage, smoothingKey)) {
+        if (request.smoothing == SmoothingType::CubicSpline && lineData->size() >= 3) {
+            const SplineKey splineKey{ lineStamp, request.smoothingParameters.splineBandwidth };
+            if (needsUpdate(_splineStage, splineKey)) {
+                _spline.fit(*lineData, splineKey.bandwidth);
+                commit(_splineStage, splineKey);
+            }
+            _spline.sample(static_cast<std::size_t>(std::max(request.smoothingParameters.sampleCount, 0)), detach(_smoothedData));
+        }
+        else {
+            applySmoothing(*lineData, request.smoothing, request.smoothingParameters, detach(_smoothedData), &_smoothingWorkspace);
+        }
+        if (cancelled())
+            return result;
+        commit(_smoothingStage, smoothingKey);
+    }
+
+    // Overlays; the published series are never written to, so a recompute simply replaces them
+    const OverlayKey overlayKey{ _normalizationStage.stamp, request.smoothing, smoothingKey.smoothingParameters, request.overlayDimensionIndices };
+    if (needsUpdate(_overlayStage, overlayKey)) {
+        const std::size_t numSourceColumns = request.overlaySource ? request.overlaySource->dimensionIndices.size() : 0;
+        if (request.overlaySource)
+            gatherSortedColumns(request.overlaySource->columns, numSourceColumns, _sortPermutation, _overlayColumns);
+        else
+            _overlayColumns.clear();
+        const std::size_t numColumns = _overlayColumns.empty() ? 0 : numSourceColumns;
+        smoothColumns(_normalizedData->xData(), _overlayColumns.data(), _normalizedData->size(), numColumns,
+            request.normalization, request.smoothing, overlayKey.smoothingParameters, _overlays, cancellation);
+        if (cancelled())
+            return result;
+        commit(_overlayStage, overlayKey);
+    }
+
+    // Presentation
+    QString selectedDimensionX = request.selectedDimensionX;
+    QString selectedDimensionY = request.selectedDimensionY;
+    if (request.switchAxes)
+        std::swap(selectedDimensionX, selectedDimensionY);
+
+    result.points = _smoothedData;
+    result.originalPoints = lineData;
+    result.statLine = statLine;
+    result.changePoints = _changePoints;
+    if (aggregating) {
+        // Groups have no single category, and the widget scans the much shorter aggregate for its bounds
+        result.categories = std::make_shared<const LineCategories>();
+        if (!_rangeLower->isEmpty()) {
+            result.rangeLower = _rangeLower;
+            result.rangeUpper = _rangeUpper;
+        }
+    }
+    else {
+        result.categories = _sortedCategories;
+        result.originalBounds = QRectF(QPointF(_normalizedStatistics.x.min, _normalizedStatistics.y.min),
+            QPointF(_normalizedStatistics.x.max, _normalizedStatistics.y.max));
+    }
+    result.overlays = _overlays;
+    result.overlayNames = request.overlayDimensionNames;
+    result.title = buildChartTitle(selectedDimensionX, selectedDimensionY, request.titleText);
+    result.xAxisName = selectedDimensionX;
+    result.yAxisName = selectedDimensionY;
+    return result;
+}
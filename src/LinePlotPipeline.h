@@ -0,0 +1,168 @@
+#pragma once
+
+#include "LinePlotUtils.h"
+#include "SmoothingFilters.h"
+#include "SmoothingSpline.h"
+#include "BatchSmoothing.h"
+#include "ChangePoints.h"
+#include "XAggregation.h"
+
+#include <QMutex>
+#include <memory>
+#include <optional>
+
+/**
+ * Memoizing line plot data pipeline
+ *
+ * Splits the data preparation into sorting, normalization, trend fitting,
+ * change point detection, grouping by X, smoothing and presentation. Each
+ * stage remembers the inputs it was computed from and is only recomputed when
+ * those, or the output of an upstream stage, change. Moving the smoothing
+ * window slider therefore only re-runs smoothing and presentation. Sorting
+ * reads the columns the GUI thread copied into the request directly. Overlay
+ * dimensions reuse the sort permutation of the main series and are smoothed
+ * together in one batch.
+ *
+ * Runs are serialized by an internal mutex; stage buffers are reused between runs
+ * unless a published result still shares them.
+ */
+class LinePlotPipeline
+{
+public:
+    /**
+     * Run the pipeline for \p request, reusing every stage whose inputs are unchanged
+     * @param request Settings snapshot taken on the GUI thread
+     * @param cancellation Checked between stages, a cancelled run leaves no partial stage behind
+     * @return Chart payload, flagged as cancelled when the run was aborted
+     */
+    LinePlotResult run(const LinePlotRequest& request, const CancellationToken& cancellation);
+
+    /** Drop all cached stages */
+    void clear();
+
+private:
+    struct SortKey {
+        std::shared_ptr<const LinePlotSource> source;   // Compared by identity, the GUI thread replaces it when the columns change
+        bool        switchAxes = false;
+        QString     sortAxisValue;
+
+        bool operator==(const SortKey&) const = default;
+    };
+
+    struct NormalizationKey {
+        quint64             sortStamp = 0;
+        NormalizationType   normalization = NormalizationType::None;
+
+        bool operator==(const NormalizationKey&) const = default;
+    };
+
+    struct TrendKey {
+        quint64         normalizationStamp = 0;
+        StatLineType    statLineType = StatLineType::LeastSquares;
+
+        bool operator==(const TrendKey&) const = default;
+    };
+
+    struct ChangePointKey {
+        quint64         normalizationStamp = 0;
+        ChangePointCost cost = ChangePointCost::None;
+        float           penalty = 0.0f;
+
+        bool operator==(const ChangePointKey&) const = default;
+    };
+
+    struct AggregationKey {
+        quint64         normalizationStamp = 0;
+        XAggregation    aggregation = XAggregation::None;
+        float           binWidth = 0.0f;
+
+        bool operator==(const AggregationKey&) const = default;
+    };
+
+    struct SmoothingKey {
+        quint64         lineStamp = 0;      // Stamp of the smoothed series, the normalized or the aggregated one
+        SmoothingType   smoothing = SmoothingType::None;
+        SmoothingParameters smoothingParameters;
+
+        bool operator==(const SmoothingKey&) const = default;
+    };
+
+    struct SplineKey {
+        quint64     lineStamp = 0;
+        float       bandwidth = 0.0f;
+
+        bool operator==(const SplineKey&) const = default;
+    };
+
+    struct OverlayKey {
+        quint64             normalizationStamp = 0;
+        SmoothingType       smoothing = SmoothingType::None;
+        SmoothingParameters smoothingParameters;
+        std::vector<int>    dimensionIndices;
+
+        bool operator==(const OverlayKey&) const = default;
+    };
+
+    /** Inputs a stage output was computed from, and a stamp identifying that output downstream */
+    template <typename Key>
+    struct StageState {
+        std::optional<Key>  key;
+        quint64             stamp = 0;
+    };
+
+    /** Returns true when \p stage must be recomputed for \p key; invalidates it until commit() */
+    template <typename Key>
+    bool needsUpdate(StageState<Key>& stage, const Key& key);
+
+    /** Returns \p buffer for writing, replacing it first when a published result still shares it */
+    template <typename T>
+    static T& detach(std::shared_ptr<T>& buffer);
+
+    /** Marks \p stage as computed from \p key */
+    template <typename Key>
+    void commit(StageState<Key>& stage, const Key& key);
+
+private:
+    QMutex                          _mutex;
+    quint64                         _stampCounter = 0;
+
+    StageState<SortKey>             _sortStage;
+    LineSeries                      _sortedData;
+    std::shared_ptr<LineCategories> _sortedCategories;
+    SortPermutation                 _sortPermutation;
+
+    // Median, MAD and clip quantiles of the sorted series, keyed by the sort stamp
+    StageState<quint64>             _robustStatisticsStage;
+    SeriesRobustStatistics          _robustStatistics;
+
+    StageState<NormalizationKey>    _normalizationStage;
+    std::shared_ptr<LineSeries>     _normalizedData;
+    SeriesStatistics                _normalizedStatistics;     // Feeds the stat line and the plot bounds
+
+    // Stat line of the normalized series, kept while hidden so showing it again is free
+    StageState<TrendKey>            _trendStage;
+    QVariantMap                     _statLine;
+
+    // Change points of the normalized series, as X positions between the points they separate
+    StageState<ChangePointKey>      _changePointStage;
+    std::vector<float>              _changePoints;
+
+    // Normalized series collapsed to one point per X group, with the Y range of every group
+    StageState<AggregationKey>      _aggregationStage;
+    std::shared_ptr<LineSeries>     _aggregatedData;
+    std::shared_ptr<LineSeries>     _rangeLower;
+    std::shared_ptr<LineSeries>     _rangeUpper;
+
+    StageState<SmoothingKey>        _smoothingStage;
+    std::shared_ptr<LineSeries>     _smoothedData;
+    SmoothingWorkspace              _smoothingWorkspace;    // Kernel scratch, kept between runs
+
+    // Fitted cubic spline, resampled without refitting when only the plot width changes
+    StageState<SplineKey>           _splineStage;
+    SmoothingSpline                 _spline;
+
+    // Overlay dimensions, gathered in sort order and smoothed as one batch
+    StageState<OverlayKey>          _overlayStage;
+    std::vector<float>              _overlayColumns;
+    std::vector<std::shared_ptr<const LineSeries>> _overlays;
+};
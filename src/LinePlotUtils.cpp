@@ -1,9 +1,17 @@
 #include "LinePlotUtils.h"
+#include "Convolution.h"
+#include "ParallelUtils.h"
+#include "RollingQuantile.h"
+#include "SavitzkyGolay.h"
+#include "SmoothingSpline.h"
 #include <QDebug>
 #include <float.h>
 #include <QColor>
 #include <QString>
 #include <array>
+#include <iterator>
+#include <numeric>
+#include <vector>
 
 // includes for mv::Dataset, Points, Clusters, NormalizationType, SmoothingType
 #include "PointData/PointData.h"
@@ -68,292 +76,475 @@ FunctionTimer::~FunctionTimer()
 }
 
 
-QVector<QPair<float, float>> applyNormalization(
-    const QVector<QPair<float, float>>& data,
-    NormalizationType type)
+namespace
 {
-    if (type == NormalizationType::None) return data;
-
-    //FunctionTimer timer(Q_FUNC_INFO);
-    int n = data.size();
-    QVector<QPair<float, float>> result;
-    result.reserve(n);
-
-    float xMean = 0, yMean = 0, xMin = FLT_MAX, xMax = -FLT_MAX, yMin = FLT_MAX, yMax = -FLT_MAX;
-    for (const auto& pt : data) {
-        xMean += pt.first;
-        yMean += pt.second;
-        if (pt.first < xMin) xMin = pt.first;
-        if (pt.first > xMax) xMax = pt.first;
-        if (pt.second < yMin) yMin = pt.second;
-        if (pt.second > yMax) yMax = pt.second;
-    }
-    xMean /= n; yMean /= n;
-
-    float xStd = 1, yStd = 1;
-    if (type == NormalizationType::ZScore) {
-        float xVar = 0, yVar = 0;
-        for (const auto& pt : data) {
-            xVar += (pt.first - xMean) * (pt.first - xMean);
-            yVar += (pt.second - yMean) * (pt.second - yMean);
-        }
-        xStd = std::max(std::sqrt(xVar / n), 1e-6f);
-        yStd = std::max(std::sqrt(yVar / n), 1e-6f);
-    }
-
-    int jx = 1, jy = 1;
-    if (type == NormalizationType::DecimalScaling) {
-        float maxAbsX = 0, maxAbsY = 0;
-        for (const auto& pt : data) {
-            maxAbsX = std::max(maxAbsX, std::fabs(pt.first));
-            maxAbsY = std::max(maxAbsY, std::fabs(pt.second));
-        }
-        jx = (int)std::ceil(std::log10(maxAbsX + 1e-6f));
-        jy = (int)std::ceil(std::log10(maxAbsY + 1e-6f));
-    }
-
-    for (const auto& pt : data) {
+    // Clamp and affine map of one column: out = (clamp(in, low, high) - offset) * scale
+    struct ColumnTransform
+    {
+        float offset = 0.0f;
+        float scale = 1.0f;
+        float low = -FLT_MAX;
+        float high = FLT_MAX;
+    };
+
+    ColumnTransform columnTransform(NormalizationType type, const ColumnStatistics& statistics, const RobustStatistics& robustStatistics)
+    {
+        ColumnTransform transform;
         switch (type) {
         case NormalizationType::ZScore:
-            result.append({ (pt.first - xMean) / xStd, (pt.second - yMean) / yStd });
+            transform.offset = static_cast<float>(statistics.mean);
+            transform.scale = 1.0f / std::max(static_cast<float>(std::sqrt(statistics.variance())), 1e-6f);
             break;
         case NormalizationType::MinMax:
-            result.append({ (pt.first - xMin) / (xMax - xMin + 1e-6f), (pt.second - yMin) / (yMax - yMin + 1e-6f) });
+            transform.offset = statistics.min;
+            transform.scale = 1.0f / (statistics.max - statistics.min + 1e-6f);
             break;
         case NormalizationType::DecimalScaling:
-            result.append({ pt.first / std::pow(10, jx), pt.second / std::pow(10, jy) });
+            transform.scale = static_cast<float>(1.0 / std::pow(10.0, static_cast<int>(std::ceil(std::log10(statistics.maxAbs() + 1e-6f)))));
+            break;
+        case NormalizationType::MedianMad:
+            // 1.4826 * MAD estimates the standard deviation of normally distributed data
+            transform.offset = robustStatistics.median;
+            transform.scale = 1.0f / std::max(1.4826f * robustStatistics.mad, 1e-6f);
+            break;
+        case NormalizationType::QuantileClip:
+            transform.low = robustStatistics.lower;
+            transform.high = robustStatistics.upper;
+            transform.offset = transform.low;
+            transform.scale = 1.0f / (transform.high - transform.low + 1e-6f);
             break;
         default:
-            result.append(pt);
             break;
         }
+        return transform;
+    }
+
+    // Element-wise, so result may be values itself
+    void applyColumnTransform(const float* values, std::size_t count, const ColumnTransform& transform, float* result)
+    {
+        parallelForChunks(count, parallelChunkCount(count, 1 << 16), [=](std::size_t, std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i)
+                result[i] = (std::min(std::max(values[i], transform.low), transform.high) - transform.offset) * transform.scale;
+            });
     }
-    return result;
 }
 
-QVector<QPair<float, float>> applyMovingAverage(const QVector<QPair<float, float>>& data, int windowSize) {
-    int n = data.size();
-    if (windowSize < 1 || n < 1) return data;
+void applyNormalization(
+    const LineSeries& data,
+    NormalizationType type,
+    LineSeries& result,
+    SeriesStatistics* statistics,
+    const SeriesRobustStatistics* robustStatistics)
+{
+    if (type == NormalizationType::None && statistics == nullptr) {
+        if (&result != &data)
+            result = data;
+        return;
+    }
 
-    QVector<QPair<float, float>> smoothed;
-    smoothed.reserve(n);
+    //FunctionTimer timer(Q_FUNC_INFO);
+    const bool robust = type == NormalizationType::MedianMad || type == NormalizationType::QuantileClip;
+    const bool clip = type == NormalizationType::QuantileClip;
+
+    // One fused pass gathers everything the classic transforms need; a clipped output is measured afterwards
+    SeriesStatistics inputStatistics;
+    if (!robust || (statistics != nullptr && !clip))
+        inputStatistics = computeSeriesStatistics(data);
+
+    SeriesRobustStatistics computedRobustStatistics;
+    if (robust && robustStatistics == nullptr) {
+        computedRobustStatistics = computeSeriesRobustStatistics(data);
+        robustStatistics = &computedRobustStatistics;
+    }
 
-    for (int i = 0; i < n; ++i) {
-        int start = std::max(0, i - windowSize / 2);
-        int end = std::min(n, i + windowSize / 2 + 1);
-        float sumY = 0;
-        for (int j = start; j < end; ++j) {
-            sumY += data[j].second;
+    const ColumnTransform xTransform = columnTransform(type, inputStatistics.x, robust ? robustStatistics->x : RobustStatistics());
+    const ColumnTransform yTransform = columnTransform(type, inputStatistics.y, robust ? robustStatistics->y : RobustStatistics());
+
+    if (type != NormalizationType::None) {
+        const std::size_t n = data.size();
+        const float* x = data.xData();
+        const float* y = data.yData();
+        result.resize(n);
+        applyColumnTransform(x, n, xTransform, result.xData());
+        applyColumnTransform(y, n, yTransform, result.yData());
+    }
+    else if (&result != &data) {
+        result = data;
+    }
+
+    if (statistics != nullptr) {
+        if (clip) {
+            *statistics = computeSeriesStatistics(result);
+        }
+        else {
+            inputStatistics.transform(xTransform.offset, xTransform.scale, yTransform.offset, yTransform.scale);
+            *statistics = inputStatistics;
         }
-        float avgY = sumY / (end - start);
-        smoothed.append({ data[i].first, avgY });
     }
-    return smoothed;
 }
 
-QVector<QPair<float, float>> applySavitzkyGolay(const QVector<QPair<float, float>>& data, int windowSize) {
-    QVector<QPair<float, float>> smoothed;
-    if (data.size() < windowSize || windowSize % 2 == 0) return data;
+void applyColumnNormalization(const float* values, std::size_t count, NormalizationType type, float* result)
+{
+    if (type == NormalizationType::None) {
+        if (result != values)
+            std::copy_n(values, count, result);
+        return;
+    }
+
+    const bool robust = type == NormalizationType::MedianMad || type == NormalizationType::QuantileClip;
+    const ColumnStatistics statistics = robust ? ColumnStatistics() : computeColumnStatistics(values, count);
+    const RobustStatistics robustStatistics = robust ? computeRobustStatistics(values, count) : RobustStatistics();
+    applyColumnTransform(values, count, columnTransform(type, statistics, robustStatistics), result);
+}
+
+void applyMovingAverage(const LineSeries& data, int windowSize, LineSeries& smoothed, SmoothingWorkspace* workspace) {
+    const int n = static_cast<int>(data.size());
+    if (windowSize < 1 || n < 1) {
+        smoothed = data;
+        return;
+    }
+
+    smoothed.resize(n);
+    std::copy(data.xData(), data.xData() + n, smoothed.xData());
+    const float* y = data.yData();
+    float* outY = smoothed.yData();
+
+    // Kahan-compensated prefix sums in double, prefix[i] is the sum of y[0, i),
+    // so every window sum is one subtraction regardless of the window size
+    SmoothingWorkspace localWorkspace;
+    std::vector<double>& prefix = (workspace ? *workspace : localWorkspace).sums;
+    prefix.resize(static_cast<std::size_t>(n) + 1);
+    double sum = 0.0, compensation = 0.0;
+    prefix[0] = 0.0;
+    for (int i = 0; i < n; ++i) {
+        const double term = static_cast<double>(y[i]) - compensation;
+        const double next = sum + term;
+        compensation = (next - sum) - term;
+        sum = next;
+        prefix[i + 1] = sum - compensation;
+    }
+
+    const int half = windowSize / 2;
+    const auto average = [&prefix](int start, int end) {
+        return static_cast<float>((prefix[end] - prefix[start]) / (end - start));
+        };
+
+    // Windows are truncated at both ends; the interior loop has a fixed width and no clamping
+    const int interiorBegin = std::min(half, n);
+    const int interiorEnd = std::max(interiorBegin, n - half);
+    const double width = 2.0 * half + 1.0;
+
+    for (int i = 0; i < interiorBegin; ++i)
+        outY[i] = average(0, std::min(n, i + half + 1));
+
+    for (int i = interiorBegin; i < interiorEnd; ++i)
+        outY[i] = static_cast<float>((prefix[i + half + 1] - prefix[i - half]) / width);
+
+    for (int i = interiorEnd; i < n; ++i)
+        outY[i] = average(std::max(0, i - half), n);
+}
+
+void applySavitzkyGolay(const LineSeries& data, int windowSize, int polynomialOrder, int derivativeOrder, LineSeries& smoothed) {
+    const int n = static_cast<int>(data.size());
+
+    // Even windows are widened to the next odd size, windows longer than the series shrunk to fit it
+    windowSize = std::min(windowSize | 1, n % 2 == 1 ? n : n - 1);
+    if (windowSize < 1 || derivativeOrder < 0) {
+        smoothed = data;
+        return;
+    }
+    polynomialOrder = std::clamp(polynomialOrder, 0, windowSize - 1);
 
     //FunctionTimer timer(Q_FUNC_INFO);
-    int half = windowSize / 2;
-    for (int i = half; i < data.size() - half; ++i) {
-        float sumY = 0;
-        for (int j = -half; j <= half; ++j) sumY += data[i + j].second;
-        smoothed.append({ data[i].first, sumY / windowSize });
+    const auto kernel = savitzkyGolayKernel(windowSize, polynomialOrder, derivativeOrder);
+    const int half = kernel->half();
+    const float* x = data.xData();
+    const float* y = data.yData();
+
+    smoothed.resize(n);
+    std::copy(x, x + n, smoothed.xData());
+    float* outY = smoothed.yData();
+
+    // Full windows
+    applyFirValid(y, n, kernel->center.data(), windowSize, outY + half);
+
+    // The first and last half windows take the fit of the first and last full window, evaluated off-center
+    const int terms = polynomialOrder + 1;
+    std::vector<double> coefficients(terms);
+    const auto fitWindow = [&](int begin) {
+        for (int k = 0; k < terms; ++k) {
+            const double* projection = kernel->projection.data() + static_cast<std::size_t>(k) * windowSize;
+            double sum = 0.0;
+            for (int j = 0; j < windowSize; ++j)
+                sum += projection[j] * y[begin + j];
+            coefficients[k] = sum;
+        }
+        };
+
+    fitWindow(0);
+    for (int i = 0; i < half; ++i)
+        outY[i] = static_cast<float>(kernel->evaluate(coefficients.data(), i - half));
+
+    fitWindow(n - windowSize);
+    for (int i = n - half; i < n; ++i)
+        outY[i] = static_cast<float>(kernel->evaluate(coefficients.data(), i - (n - windowSize) - half));
+
+    // Derivatives are per sample so far, express them per X unit using the mean sample spacing
+    if (derivativeOrder > 0 && n > 1) {
+        const double spacing = (static_cast<double>(x[n - 1]) - x[0]) / (n - 1);
+        if (spacing != 0.0) {
+            const float factor = static_cast<float>(1.0 / std::pow(spacing, derivativeOrder));
+            for (int i = 0; i < n; ++i)
+                outY[i] *= factor;
+        }
     }
-    return smoothed;
 }
 
-QVector<QPair<float, float>> applyGaussian(const QVector<QPair<float, float>>& data, int windowSize) {
-    QVector<QPair<float, float>> smoothed;
-    int n = data.size();
-    if (n < windowSize || windowSize % 2 == 0) return data;
+// Below this sigma the recursive approximation drifts from the sampled Gaussian, the direct kernel is used instead
+static constexpr float kRecursiveGaussianMinimumSigma = 2.5f;
+
+// Young-van Vliet recursive Gaussian: a causal and an anti-causal third order IIR pass
+// whose cost does not depend on sigma. Edges are extended with the boundary samples.
+static void applyRecursiveGaussian(const float* y, int n, double sigma, std::vector<double>& forward, float* out)
+{
+    const double q = sigma >= 2.5
+        ? 0.98711 * sigma - 0.96330
+        : 3.97156 - 4.14554 * std::sqrt(1.0 - 0.26891 * sigma);
+    const double q2 = q * q;
+    const double q3 = q2 * q;
+
+    const double b0 = 1.57825 + 2.44413 * q + 1.4281 * q2 + 0.422205 * q3;
+    const double b1 = (2.44413 * q + 2.85619 * q2 + 1.26661 * q3) / b0;
+    const double b2 = -(1.4281 * q2 + 1.26661 * q3) / b0;
+    const double b3 = (0.422205 * q3) / b0;
+    const double gain = 1.0 - (b1 + b2 + b3);
+
+    forward.resize(n);
+    double w1 = y[0], w2 = y[0], w3 = y[0];
+    for (int i = 0; i < n; ++i) {
+        const double w = gain * y[i] + b1 * w1 + b2 * w2 + b3 * w3;
+        forward[i] = w;
+        w3 = w2;
+        w2 = w1;
+        w1 = w;
+    }
+
+    double v1 = forward[n - 1], v2 = forward[n - 1], v3 = forward[n - 1];
+    for (int i = n - 1; i >= 0; --i) {
+        const double v = gain * forward[i] + b1 * v1 + b2 * v2 + b3 * v3;
+        out[i] = static_cast<float>(v);
+        v3 = v2;
+        v2 = v1;
+        v1 = v;
+    }
+}
+
+void applyGaussian(const LineSeries& data, int windowSize, LineSeries& smoothed, SmoothingWorkspace* workspace) {
+    const int n = static_cast<int>(data.size());
+    if (n < windowSize || windowSize % 2 == 0) {
+        smoothed = data;
+        return;
+    }
 
     //FunctionTimer timer(Q_FUNC_INFO);
-    smoothed.reserve(n - windowSize + 1);
-
-    int half = windowSize / 2;
-    QVector<float> kernel(windowSize);
-    float sigma = windowSize / 6.0f;
-    float sum = 0.0f;
-    for (int i = 0; i < windowSize; ++i) {
-        int x = i - half;
-        kernel[i] = expf(-0.5f * (x * x) / (sigma * sigma));
-        sum += kernel[i];
-    }
-    for (float& val : kernel) val /= sum;
-
-    for (int i = half; i < n - half; ++i) {
-        float y = 0.0f;
-        for (int j = -half; j <= half; ++j)
-            y += data[i + j].second * kernel[j + half];
-        smoothed.append({ data[i].first, y });
-    }
-    return smoothed;
+    const int half = windowSize / 2;
+    const float sigma = windowSize / 6.0f;
+    const float* x = data.xData();
+    const float* y = data.yData();
+
+    // Only the samples with a full window are kept, as with the direct kernel
+    smoothed.resize(n - 2 * half);
+    std::copy(x + half, x + n - half, smoothed.xData());
+    float* outY = smoothed.yData();
+
+    if (sigma < kRecursiveGaussianMinimumSigma) {
+        std::vector<float> kernel(windowSize);
+        float sum = 0.0f;
+        for (int i = 0; i < windowSize; ++i) {
+            int offset = i - half;
+            kernel[i] = expf(-0.5f * (offset * offset) / (sigma * sigma));
+            sum += kernel[i];
+        }
+        for (float& val : kernel) val /= sum;
+
+        applyFirValid(y, n, kernel.data(), windowSize, outY);
+        return;
+    }
+
+    SmoothingWorkspace localWorkspace;
+    SmoothingWorkspace& scratch = workspace ? *workspace : localWorkspace;
+    std::vector<float>& filtered = scratch.values;
+    filtered.resize(n);
+    applyRecursiveGaussian(y, n, sigma, scratch.sums, filtered.data());
+    std::copy(filtered.begin() + half, filtered.end() - half, outY);
 }
 
-QVector<QPair<float, float>> applyExponentialMovingAverage(const QVector<QPair<float, float>>& data, float alpha) {
-    QVector<QPair<float, float>> smoothed;
-    if (data.isEmpty()) return data;
+void applyExponentialMovingAverage(const LineSeries& data, LineSeries& smoothed, float alpha) {
+    if (data.isEmpty()) {
+        smoothed = data;
+        return;
+    }
 
     //FunctionTimer timer(Q_FUNC_INFO);
-    float ema = data[0].second;
-    for (const auto& point : data) {
-        ema = alpha * point.second + (1 - alpha) * ema;
-        smoothed.append({ point.first, ema });
+    const std::size_t n = data.size();
+    smoothed.resize(n);
+    std::copy(data.xData(), data.xData() + n, smoothed.xData());
+    const float* y = data.yData();
+    float* outY = smoothed.yData();
+    float ema = y[0];
+    for (std::size_t i = 0; i < n; ++i) {
+        ema = alpha * y[i] + (1 - alpha) * ema;
+        outY[i] = ema;
     }
-    return smoothed;
 }
 
-QVector<QPair<float, float>> applyRunningMedian(const QVector<QPair<float, float>>& data, int windowSize) {
-    QVector<QPair<float, float>> smoothed;
-    int n = data.size();
-    if (n < windowSize || windowSize % 2 == 0) return data;
+void applyRunningQuantile(const LineSeries& data, int windowSize, float quantile, LineSeries& smoothed, SmoothingWorkspace* workspace) {
+    const int n = static_cast<int>(data.size());
+    if (n < windowSize || windowSize % 2 == 0) {
+        smoothed = data;
+        return;
+    }
 
    // FunctionTimer timer(Q_FUNC_INFO);
-    smoothed.reserve(n - windowSize + 1);
-
-    std::multiset<float> window;
+    const float* x = data.xData();
+    const float* y = data.yData();
+    smoothed.resize(n - windowSize + 1);
+    float* outX = smoothed.xData();
+    float* outY = smoothed.yData();
+
+    // Handles of the window values in insertion order, the oldest one is replaced on every step
+    SmoothingWorkspace localWorkspace;
+    SmoothingWorkspace& scratch = workspace ? *workspace : localWorkspace;
+    RollingQuantile& window = scratch.quantile;
+    window.clear();
+    window.setQuantile(quantile);
+    window.reserve(windowSize);
+    std::vector<RollingQuantile::Handle>& handles = scratch.indices;
+    handles.resize(windowSize);
     for (int i = 0; i < windowSize; ++i)
-        window.insert(data[i].second);
+        handles[i] = window.insert(y[i]);
 
-    auto mid = std::next(window.begin(), windowSize / 2);
     for (int i = windowSize; i <= n; ++i) {
-        smoothed.append({ data[i - windowSize / 2 - 1].first, *mid });
+        outX[i - windowSize] = x[i - windowSize / 2 - 1];
+        outY[i - windowSize] = window.value();
         if (i == n) break;
-        window.erase(window.find(data[i - windowSize].second));
-        window.insert(data[i].second);
-        mid = std::next(window.begin(), windowSize / 2);
+        auto& oldest = handles[i % windowSize];
+        window.erase(oldest);
+        oldest = window.insert(y[i]);
     }
-    return smoothed;
 }
 
-QVector<QPair<float, float>> applyLinearInterpolation(const QVector<QPair<float, float>>& data, int step) {
+void applyRunningMedian(const LineSeries& data, int windowSize, LineSeries& smoothed, SmoothingWorkspace* workspace) {
+    applyRunningQuantile(data, windowSize, 0.5f, smoothed, workspace);
+}
+
+void applyLinearInterpolation(const LineSeries& data, int step, LineSeries& interpolated) {
     //FunctionTimer timer(Q_FUNC_INFO);
-    QVector<QPair<float, float>> interpolated;
-    for (int i = 0; i < data.size() - step; i += step) {
-        interpolated.append(data[i]);
-        float midX = (data[i].first + data[i + step].first) / 2.0f;
-        float midY = (data[i].second + data[i + step].second) / 2.0f;
-        interpolated.append({ midX, midY });
-    }
-    interpolated.append(data.last());
-    return interpolated;
+    interpolated.clear();
+    const int n = static_cast<int>(data.size());
+    if (n == 0)
+        return;
+    if (step < 1)
+        step = 1;
+
+    interpolated.reserve(2 * (n / step) + 1);
+    for (int i = 0; i < n - step; i += step) {
+        interpolated.append(data.x(i), data.y(i));
+        float midX = (data.x(i) + data.x(i + step)) / 2.0f;
+        float midY = (data.y(i) + data.y(i + step)) / 2.0f;
+        interpolated.append(midX, midY);
+    }
+    interpolated.append(data.x(n - 1), data.y(n - 1));
 }
 
-QVector<QPair<float, float>> applyCubicSplineApproximation(const QVector<QPair<float, float>>& data) {
-    QVector<QPair<float, float>> smoothed;
-    if (data.size() < 3) return data;
+void applyCubicSpline(const LineSeries& data, float bandwidth, int sampleCount, LineSeries& smoothed) {
+    if (data.size() < 3) {
+        smoothed = data;
+        return;
+    }
 
     //FunctionTimer timer(Q_FUNC_INFO);
-    smoothed.append(data.first());
-    for (int i = 1; i < data.size() - 1; ++i) {
-        float x = (data[i - 1].first + data[i].first + data[i + 1].first) / 3.0f;
-        float y = (data[i - 1].second + data[i].second + data[i + 1].second) / 3.0f;
-        smoothed.append({ x, y });
-    }
-    smoothed.append(data.last());
-    return smoothed;
+    SmoothingSpline spline;
+    spline.fit(data, bandwidth);
+    spline.sample(static_cast<std::size_t>(std::max(sampleCount, 0)), smoothed);
 }
 
-QVector<QPair<float, float>> applyMinMaxSampling(const QVector<QPair<float, float>>& data, int windowSize) {
+void applyMinMaxSampling(const LineSeries& data, int windowSize, LineSeries& result) {
     //FunctionTimer timer(Q_FUNC_INFO);
-    QVector<QPair<float, float>> result;
-    for (int i = 0; i < data.size(); i += windowSize) {
-        int end = std::min(i + windowSize, static_cast<int>(data.size()));
+    result.clear();
+    const int n = static_cast<int>(data.size());
+    if (windowSize < 1)
+        windowSize = 1;
+
+    const float* y = data.yData();
+    result.reserve(2 * (n / windowSize + 1));
+    for (int i = 0; i < n; i += windowSize) {
+        int end = std::min(i + windowSize, n);
         if (end - i < 2) {
-            result.append(data[i]);
+            result.append(data.x(i), data.y(i));
             continue;
         }
-        auto minIt = std::min_element(data.begin() + i, data.begin() + end, [](auto a, auto b) { return a.second < b.second; });
-        auto maxIt = std::max_element(data.begin() + i, data.begin() + end, [](auto a, auto b) { return a.second < b.second; });
-        result.append(*minIt);
-        if (minIt != maxIt) result.append(*maxIt);
+        const int minIdx = static_cast<int>(std::min_element(y + i, y + end) - y);
+        const int maxIdx = static_cast<int>(std::max_element(y + i, y + end) - y);
+        result.append(data.x(minIdx), data.y(minIdx));
+        if (minIdx != maxIdx) result.append(data.x(maxIdx), data.y(maxIdx));
     }
-    return result;
 }
 
 void sortDataAndCategories(
-    const QVector<QPair<float, float>>& rawData,
-    const QVector<QPair<QString, QColor>>& categoryValues,
-    QVector<QPair<float, float>>& sortedData,
-    QVector<QPair<QString, QColor>>& sortedCategories,
-    QString axis = "X")
+    const LineSeries& rawData,
+    const LineCategories& categoryValues,
+    bool switchAxes,
+    LineSeries& sortedData,
+    LineCategories& sortedCategories,
+    SortPermutation& permutation,
+    QString axis)
 {
-    bool alreadySorted = true;
-    for (int i = 1; i < rawData.size(); ++i) {
-        if ((axis == "X" && rawData[i - 1].first > rawData[i].first) ||
-            (axis == "Y" && rawData[i - 1].second > rawData[i].second)) {
-            alreadySorted = false;
-            break;
-        }
-    }
-    bool hasCategories = !categoryValues.isEmpty();
-
-    if (alreadySorted) {
-        sortedData = rawData;
+    const std::size_t n = rawData.size();
+    const float* x = switchAxes ? rawData.yData() : rawData.xData();
+    const float* y = switchAxes ? rawData.xData() : rawData.yData();
+    const float* keys = (axis == "Y") ? y : x;
+    const bool hasCategories = categoryValues.size() == n && n > 0;
+
+    sortedCategories.clear();
+    if (std::is_sorted(keys, keys + n)) {
+        permutation.resize(n);
+        std::iota(permutation.begin(), permutation.end(), std::uint32_t(0));
+        sortedData.resize(n);
+        std::copy_n(x, n, sortedData.xData());
+        std::copy_n(y, n, sortedData.yData());
         if (hasCategories) {
             sortedCategories = categoryValues;
         }
+        return;
     }
-    else {
-        QVector<int> indices(rawData.size());
-        std::iota(indices.begin(), indices.end(), 0);
-        std::sort(indices.begin(), indices.end(), [&](int a, int b) {
-            return (axis =="X")
-                ? rawData[a].first < rawData[b].first
-                : rawData[a].second < rawData[b].second;
-            });
 
-        sortedData.reserve(rawData.size());
-        if (hasCategories) {
-            sortedCategories.reserve(categoryValues.size());
-        }
+    radixSortPermutation(keys, n, permutation);
 
-        for (int idx : indices) {
-            sortedData.append(rawData[idx]);
-            if (hasCategories && idx < categoryValues.size()) {
-                sortedCategories.append(categoryValues[idx]);
-            }
-        }
+    sortedData.resize(n);
+    gatherByPermutation(x, permutation, sortedData.xData());
+    gatherByPermutation(y, permutation, sortedData.yData());
+
+    if (hasCategories) {
+        sortedCategories.copyPalette(categoryValues);
+        sortedCategories.resize(n);
+        gatherByPermutation(categoryValues.codeData(), permutation, sortedCategories.codeData());
     }
 }
 
-QVariantMap calculateStatLine(const QVector<QPair<float, float>>& normalizedData)
+QVariantMap calculateStatLine(const SeriesStatistics& statistics)
 {
     QVariantMap statLine;
-    if (normalizedData.size() >= 2) {
-        const int n = normalizedData.size();
-        const int n_half = (n + 1) / 2;  // Round up for odd numbers
-
-        float sumStartX = 0, sumStartY = 0;
-        float sumEndX = 0, sumEndY = 0;
-
-        const int endStart = std::min(n_half, n);
-        const int startEnd = std::max(n - n_half, 0);
-
-        for (int i = 0; i < endStart; ++i) {
-            sumStartX += normalizedData[i].first;
-            sumStartY += normalizedData[i].second;
-        }
-        for (int i = startEnd; i < n; ++i) {
-            sumEndX += normalizedData[i].first;
-            sumEndY += normalizedData[i].second;
-        }
-
-        const float actualStartCount = endStart;
-        const float actualEndCount = n - startEnd;
-
-        float meanStartX = sumStartX / actualStartCount;
-        float meanStartY = sumStartY / actualStartCount;
-        float meanEndX = sumEndX / actualEndCount;
-        float meanEndY = sumEndY / actualEndCount;
-
-        statLine["start_x"] = meanStartX;
-        statLine["start_y"] = meanStartY;
-        statLine["end_x"] = meanEndX;
-        statLine["end_y"] = meanEndY;
+    if (statistics.size() >= 2) {
+        // The head and tail halves overlap in the middle point of an odd series
+        const int n_half = static_cast<int>(statistics.headX.count);
+        const float actualStartCount = static_cast<float>(statistics.headX.count);
+        const float actualEndCount = static_cast<float>(statistics.tailX.count);
+
+        statLine["start_x"] = static_cast<float>(statistics.headX.mean);
+        statLine["start_y"] = static_cast<float>(statistics.headY.mean);
+        statLine["end_x"] = static_cast<float>(statistics.tailX.mean);
+        statLine["end_y"] = static_cast<float>(statistics.tailY.mean);
         statLine["start_label"] = QString("Mean first %1").arg(n_half);
         statLine["end_label"] = QString("Mean last %1").arg(n_half);
         statLine["color"] = "#000000";
@@ -363,185 +554,127 @@ QVariantMap calculateStatLine(const QVector<QPair<float, float>>& normalizedData
     return statLine;
 }
 
-QVariantList buildPayload(
-    const QVector<QPair<float, float>>& smoothedData,
-    const QVector<QPair<QString, QColor>>& sortedCategories)
+QVariantMap calculateTrendStatLine(const TrendLine& trend, const SeriesStatistics& statistics, const QString& name)
 {
-    QVariantList payload;
-    bool hasCategories = !sortedCategories.isEmpty();
-    payload.reserve(smoothedData.size());
-    for (int i = 0; i < smoothedData.size(); ++i) {
-        QVariantMap entry;
-        entry["x"] = smoothedData[i].first;
-        entry["y"] = smoothedData[i].second;
-        if (hasCategories && i < sortedCategories.size() && !sortedCategories[i].first.isEmpty()) {
-            const auto& cat = sortedCategories[i];
-            entry["category"] = QVariantList{ cat.second.name(), cat.first };
-        }
-        payload.append(entry);
-    }
-    return payload;
+    QVariantMap statLine;
+    if (!trend.valid)
+        return statLine;
+
+    // The lines of the slope bounds cross at the pivot and fan out towards the ends
+    const double startX = statistics.x.min;
+    const double endX = statistics.x.max;
+    const auto boundAt = [&trend](double slope, double x) { return trend.pivotY + slope * (x - trend.pivotX); };
+
+    statLine["start_x"] = static_cast<float>(startX);
+    statLine["start_y"] = static_cast<float>(trend.valueAt(startX));
+    statLine["end_x"] = static_cast<float>(endX);
+    statLine["end_y"] = static_cast<float>(trend.valueAt(endX));
+    statLine["start_label"] = name;
+    statLine["end_label"] = QString("Slope %1 [%2, %3]")
+        .arg(trend.slope, 0, 'g', 3)
+        .arg(trend.slopeLower, 0, 'g', 3)
+        .arg(trend.slopeUpper, 0, 'g', 3);
+    statLine["label"] = name;
+    statLine["color"] = "#000000";
+    statLine["n_start"] = static_cast<float>(trend.count);
+    statLine["n_end"] = static_cast<float>(trend.count);
+    statLine["slope"] = trend.slope;
+    statLine["intercept"] = trend.intercept;
+    statLine["slope_lower"] = trend.slopeLower;
+    statLine["slope_upper"] = trend.slopeUpper;
+    statLine["intercept_lower"] = trend.interceptLower;
+    statLine["intercept_upper"] = trend.interceptUpper;
+    statLine["pivot_x"] = trend.pivotX;
+    statLine["pivot_y"] = trend.pivotY;
+    statLine["ci_start_y1"] = boundAt(trend.slopeLower, startX);
+    statLine["ci_start_y2"] = boundAt(trend.slopeUpper, startX);
+    statLine["ci_end_y1"] = boundAt(trend.slopeLower, endX);
+    statLine["ci_end_y2"] = boundAt(trend.slopeUpper, endX);
+    return statLine;
 }
 
-QVariant prepareData(
-    QVector<float>& coordvalues,
-    QVector<QPair<QString, QColor>>& categoryValues,
-    SmoothingType smoothing,
-    int smoothingParam,
-    NormalizationType normalization,
+QString buildChartTitle(
     const QString& selectedDimensionX,
     const QString& selectedDimensionY,
-    const QString& titleText,
-    const QString& sortAxisValue
-)
+    const QString& titleText)
 {
-    //qDebug() << "prepareData: called";
-    //qDebug() << "  coordvalues.size() =" << coordvalues.size();
-    //qDebug() << "  categoryValues.size() =" << categoryValues.size();
-    //qDebug() << "  smoothing =" << static_cast<int>(smoothing) << " smoothingParam =" << smoothingParam << " normalization =" << static_cast<int>(normalization);
-
-    if (coordvalues.isEmpty() || coordvalues.size() % 2 != 0) {
-        qCritical() << "prepareData: Invalid input data";
-        return QVariant();
-    }
-
-    //FunctionTimer timer(Q_FUNC_INFO);
-
-    // Convert flat coordvalues to point pairs
-    QVector<QPair<float, float>> rawData;
-    rawData.reserve(coordvalues.size() / 2);
-    for (int i = 0; i < coordvalues.size(); i += 2) {
-        rawData.append({ coordvalues[i], coordvalues[i + 1] });
-    }
-    //qDebug() << "prepareData: rawData.size() =" << rawData.size();
-    //if (!rawData.isEmpty()) {
-       // qDebug() << "prepareData: rawData sample:" << rawData.first() << (rawData.size() > 1 ? rawData[1] : QPair<float,float>());
-    //}
-
-    // Sort by X, keeping optional categoryValues in sync if they exist
-    QVector<QPair<float, float>> sortedData;
-    QVector<QPair<QString, QColor>> sortedCategories;
-    sortDataAndCategories(rawData, categoryValues, sortedData, sortedCategories, sortAxisValue);
-    //if (!sortedData.isEmpty()) {
-        //qDebug() << "prepareData: sortedData sample:" << sortedData.first() << (sortedData.size() > 1 ? sortedData[1] : QPair<float,float>());
-    //}
-
-    // Apply normalization BEFORE smoothing
-    //qDebug() << "prepareData: applying normalization type =" << static_cast<int>(normalization);
-    QVector<QPair<float, float>> normalizedData = applyNormalization(sortedData, normalization);
-    //if (!normalizedData.isEmpty()) {
-        //qDebug() << "prepareData: normalizedData sample:" << normalizedData.first() << (normalizedData.size() > 1 ? normalizedData[1] : QPair<float,float>());
-    //}
-
-    // Calculate statLine
-    QVariantMap statLine = calculateStatLine(normalizedData);
-    //if (!statLine.isEmpty()) {
-        //qDebug() << "prepareData: statLine =" << statLine;
-    //}
-
-    // Apply smoothing to normalized data
-    //qDebug() << "prepareData: applying smoothing type =" << static_cast<int>(smoothing) << " param =" << smoothingParam;
-    QVector<QPair<float, float>> smoothedData;
-    switch (smoothing) {
-    case SmoothingType::MovingAverage:
-        smoothedData = applyMovingAverage(normalizedData, smoothingParam);
-        break;
-    case SmoothingType::SavitzkyGolay:
-        smoothedData = applySavitzkyGolay(normalizedData, smoothingParam);
-        break;
-    case SmoothingType::Gaussian:
-        smoothedData = applyGaussian(normalizedData, smoothingParam);
-        break;
-    case SmoothingType::ExponentialMovingAverage:
-        smoothedData = applyExponentialMovingAverage(normalizedData);
-        break;
-    case SmoothingType::CubicSpline:
-        smoothedData = applyCubicSplineApproximation(normalizedData);
-        break;
-    case SmoothingType::LinearInterpolation:
-        smoothedData = applyLinearInterpolation(normalizedData, smoothingParam);
-        break;
-    case SmoothingType::MinMaxSampling:
-        smoothedData = applyMinMaxSampling(normalizedData, smoothingParam);
-        break;
-    case SmoothingType::RunningMedian:
-        smoothedData = applyRunningMedian(normalizedData, smoothingParam);
-        break;
-    case SmoothingType::None:
-    default:
-        smoothedData = normalizedData;
-        break;
-    }
-    if (!smoothedData.isEmpty()) {
-        //qDebug() << "prepareData: smoothedData sample:" << smoothedData.first() << (smoothedData.size() > 1 ? smoothedData[1] : QPair<float,float>());
-    }
-
-    // Convert back to QVariantList with optional categories
-    QVariantList payload = buildPayload(smoothedData, sortedCategories);
-   // qDebug() << "prepareData: payload.size() =" << payload.size();
-    QVariantList fullPayload = buildPayload(normalizedData, sortedCategories);
-
-    QVariantMap root;
-    root["data"] = payload;
-    root["original"] = fullPayload;
-    if (!statLine.isEmpty()) {
-        root["statLine"] = statLine;
-    }
-    root["lineColor"] = "#1f77b4";
-
-    root["title"] = titleText.isEmpty()
+    return titleText.isEmpty()
         ? QString("%1 vs %2").arg(selectedDimensionX, selectedDimensionY)
         : titleText;
-
-    root["xAxisName"] = selectedDimensionX;
-    root["yAxisName"] = selectedDimensionY;
-
-    //qDebug() << "prepareData: root keys =" << root.keys();
-
-    return root;
 }
 
+// Number of colormap levels used to encode point-dataset colors as categories
+static constexpr int kColormapLevels = 256;
 
+// Copies the X and Y columns of a row-major point buffer into two planar arrays
+// in a single pass. Instantiated for every element type Points can store.
+template <typename InputIterator>
+static void extractDimensionPair(
+    InputIterator begin,
+    std::size_t numPoints,
+    std::size_t numDimensions,
+    int dimensionXIndex,
+    int dimensionYIndex,
+    float* xValues,
+    float* yValues)
+{
+    auto row = begin;
+    for (std::size_t i = 0; i < numPoints; ++i, row += numDimensions) {
+        xValues[i] = static_cast<float>(row[dimensionXIndex]);
+        yValues[i] = static_cast<float>(row[dimensionYIndex]);
+    }
+}
 
 void extractLinePlotData(
-    const mv::Dataset<Points>& currentDataSet,
+    const Points* currentDataSet,
     int dimensionXIndex,
     int dimensionYIndex,
-    QString colorDatasetID,
+    DatasetImpl* colorDataset,
     int colorPointDatasetDimensionIndex,
     QString colormapSelectedVal,
     float minValue,
     float maxValue,
-    QVector<float>& coordvalues,
-    QVector<QPair<QString, QColor>>& categoryValues
+    LineSeries& lineData,
+    LineCategories& categoryValues
 ) {
-    coordvalues.clear();
+    lineData.clear();
     categoryValues.clear();
-    auto colorDataset= mv::data().getDataset(colorDatasetID);
-    if (!currentDataSet.isValid() || dimensionXIndex < 0 || dimensionYIndex < 0)
+    if (currentDataSet == nullptr || dimensionXIndex < 0 || dimensionYIndex < 0)
         return;
 
     const auto numPoints = currentDataSet->getNumPoints();
     const auto numDimensions = currentDataSet->getNumDimensions();
 
-    coordvalues.reserve(numPoints * 2);
-    for (unsigned int i = 0; i < numPoints; ++i) {
-        float xValue = currentDataSet->getValueAt(i * numDimensions + dimensionXIndex);
-        float yValue = currentDataSet->getValueAt(i * numDimensions + dimensionYIndex);
-        coordvalues.push_back(xValue);
-        coordvalues.push_back(yValue);
+    if (dimensionXIndex >= static_cast<int>(numDimensions) || dimensionYIndex >= static_cast<int>(numDimensions)) {
+        qCritical() << "extractLinePlotData: Dimension index out of range";
+        return;
     }
 
-    categoryValues.reserve(numPoints);
-    for (unsigned int i = 0; i < numPoints; ++i) {
-        categoryValues.push_back({ QString(), QColor() });
+    lineData.resize(numPoints);
+
+    // Read both columns straight from the underlying buffer, whatever its element type
+    bool extracted = false;
+    currentDataSet->constVisitFromBeginToEnd([&](auto begin, auto end) {
+        const auto available = static_cast<std::size_t>(std::distance(begin, end));
+        if (available < static_cast<std::size_t>(numPoints) * numDimensions)
+            return;
+        extractDimensionPair(begin, numPoints, numDimensions, dimensionXIndex, dimensionYIndex, lineData.xData(), lineData.yData());
+        extracted = true;
+    });
+
+    if (!extracted) {
+        qCritical() << "extractLinePlotData: Point buffer is smaller than expected";
+        lineData.clear();
+        return;
     }
 
-    if (colorDataset.isValid()) {
+    if (colorDataset != nullptr) {
+        categoryValues.resize(numPoints, LineCategories::NoCategory);
+
         if (colorDataset->getDataType() == ClusterType)
         {
-            Dataset<Clusters> clusterDataset = mv::data().getDataset(colorDatasetID);
-            if (clusterDataset.isValid())
+            auto clusterDataset = static_cast<Clusters*>(colorDataset);
+            if (clusterDataset != nullptr)
             {
                 auto clusters = clusterDataset->getClusters();
                 for (const auto& cluster : clusters) {
@@ -549,21 +682,23 @@ void extractLinePlotData(
                     auto clusterColor = cluster.getColor();
                     auto clusterIndices = cluster.getIndices();
                     if (clusterName.isEmpty() || !clusterColor.isValid() || clusterIndices.empty()) continue;
+                    const auto code = categoryValues.addCategory(clusterName, clusterColor);
+                    auto* codes = categoryValues.codeData();
                     for (const auto& index : clusterIndices) {
                         if (index < numPoints) {
-                            categoryValues[index] = { clusterName, clusterColor };
+                            codes[index] = code;
                         }
                     }
                 }
             }
             else
             {
-                qCritical() << "extractLinePlotData: Invalid cluster dataset:" << colorDatasetID;
+                qCritical() << "extractLinePlotData: Invalid cluster dataset:" << colorDataset->getId();
             }
         }
         else if (colorDataset->getDataType() == PointType) {
-            Dataset<Points> pointDataset = mv::data().getDataset(colorDatasetID);
-            if (pointDataset.isValid())
+            auto pointDataset = static_cast<Points*>(colorDataset);
+            if (pointDataset != nullptr)
             {
                 int numofPoints = pointDataset->getNumPoints();
                 if(numofPoints>0)
@@ -579,13 +714,30 @@ void extractLinePlotData(
                         //float maxValue = *std::max_element(pointsValues.begin(), pointsValues.end());
                        
 
-                        for (unsigned int i = 0; i < numofPoints; ++i) {
-                            float value = pointsValues[i];
+                        // Quantize the values onto a fixed number of colormap levels, one palette entry each
+                        const int levels = (maxValue > minValue) ? kColormapLevels : 1;
+                        const float binWidth = (maxValue - minValue) / levels;
+                        const float scale = (maxValue > minValue) ? levels / (maxValue - minValue) : 0.0f;
+                        for (int level = 0; level < levels; ++level) {
+                            const float lower = minValue + level * binWidth;
+                            const float upper = lower + binWidth;
+                            QString label;
+                            if (levels == 1)
+                                label = QString::number(minValue);
+                            else if (level == 0)
+                                label = QString("<= %1").arg(upper, 0, 'g', 4);
+                            else if (level == levels - 1)
+                                label = QString(">= %1").arg(lower, 0, 'g', 4);
+                            else
+                                label = QString("%1 to %2").arg(lower, 0, 'g', 4).arg(upper, 0, 'g', 4);
+                            categoryValues.addCategory(label, getColorFromColormap(lower + 0.5f * binWidth, colormap, minValue, maxValue));
+                        }
 
-                            QColor color = getColorFromColormap(value, colormap, minValue, maxValue);
-                            if (i < numPoints) {
-                                categoryValues[i] = { QString::number(value), color };
-                            }
+                        auto* codes = categoryValues.codeData();
+                        const unsigned int count = std::min(static_cast<unsigned int>(numofPoints), numPoints);
+                        for (unsigned int i = 0; i < count; ++i) {
+                            const float t = (pointsValues[i] - minValue) * scale;
+                            codes[i] = t > 0.0f ? static_cast<LineCategories::Code>(std::min(static_cast<int>(t), levels - 1)) : 0;
                         }
                     }
                     else
@@ -595,12 +747,12 @@ void extractLinePlotData(
                 }
                 else
                 {
-                    qCritical() << "extractLinePlotData: No points in dataset:" << colorDatasetID;
+                    qCritical() << "extractLinePlotData: No points in dataset:" << colorDataset->getId();
                 }
             }
             else
             {
-                qCritical() << "extractLinePlotData: Invalid point dataset:" << colorDatasetID;
+                qCritical() << "extractLinePlotData: Invalid point dataset:" << colorDataset->getId();
             }
 
 
@@ -611,4 +763,69 @@ void extractLinePlotData(
 
     
     }
-}
\ No newline at end of file
+}
+
+void extractColumns(
+    const Points* currentDataSet,
+    const std::vector<int>& dimensionIndices,
+    std::vector<float>& columns
+) {
+    columns.clear();
+    if (currentDataSet == nullptr || dimensionIndices.empty())
+        return;
+
+    const std::size_t numPoints = currentDataSet->getNumPoints();
+    const std::size_t numDimensions = currentDataSet->getNumDimensions();
+    const std::size_t numColumns = dimensionIndices.size();
+
+    for (const int dimensionIndex : dimensionIndices) {
+        if (dimensionIndex < 0 || dimensionIndex >= static_cast<int>(numDimensions)) {
+            qCritical() << "extractColumns: Dimension index out of range";
+            return;
+        }
+    }
+
+    columns.resize(numPoints * numColumns);
+
+    // Rows are read once each and scattered over the columns
+    bool extracted = false;
+    currentDataSet->constVisitFromBeginToEnd([&](auto begin, auto end) {
+        const auto available = static_cast<std::size_t>(std::distance(begin, end));
+        if (available < numPoints * numDimensions)
+            return;
+        parallelForChunks(numPoints, parallelChunkCount(numPoints, 1 << 14), [&](std::size_t, std::size_t chunkBegin, std::size_t chunkEnd) {
+            for (std::size_t i = chunkBegin; i < chunkEnd; ++i) {
+                const auto row = begin + static_cast<std::ptrdiff_t>(i * numDimensions);
+                for (std::size_t column = 0; column < numColumns; ++column)
+                    columns[column * numPoints + i] = static_cast<float>(row[dimensionIndices[column]]);
+            }
+            });
+        extracted = true;
+    });
+
+    if (!extracted) {
+        qCritical() << "extractColumns: Point buffer is smaller than expected";
+        columns.clear();
+    }
+}
+
+void gatherSortedColumns(
+    const std::vector<float>& sourceColumns,
+    std::size_t numColumns,
+    const SortPermutation& permutation,
+    std::vector<float>& columns
+) {
+    columns.clear();
+    if (numColumns == 0 || sourceColumns.empty())
+        return;
+
+    const std::size_t count = permutation.size();
+    if (sourceColumns.size() != count * numColumns) {
+        qCritical() << "gatherSortedColumns: Column size does not match the sort permutation";
+        return;
+    }
+
+    columns.resize(count * numColumns);
+    for (std::size_t column = 0; column < numColumns; ++column)
+        gatherByPermutation(sourceColumns.data() + column * count, permutation, columns.data() + column * count);
+}
@@ -3,19 +3,28 @@
 #include <QVector>
 #include <QPair>
 #include <QString>
+#include <QStringList>
 #include <QElapsedTimer>
 #include <QColor>
+#include <QRectF>
 #include <QVariantMap>
 #include <QVariantList>
 #include <cmath>
 #include <algorithm>
-#include <set>
+#include <memory>
 
 // includes for mv::Dataset, Points, Clusters, NormalizationType, SmoothingType
 #include "PointData/PointData.h"
 #include "ClusterData/ClusterData.h"
 #include "LinePlotViewPlugin.h" // for NormalizationType, SmoothingType
 #include  "ColorUtils.h" // for QColor utilities
+#include "CancellationToken.h"
+#include "RadixSort.h"
+#include "SeriesStatistics.h"
+#include "SmoothingWorkspace.h"
+#include "TrendLine.h"
+#include "../libs/LineChartLib/LineSeries.h"
+#include "../libs/LineChartLib/LineCategories.h"
 
 using namespace mv;
 
@@ -29,58 +38,181 @@ private:
     QElapsedTimer _timer;
 };
 
+// Inputs a LinePlotSource is copied from
+struct LinePlotSourceKey {
+    QString             pointDatasetId;
+    quint64             pointDatasetRevision = 0;
+    int                 dimensionXIndex = -1;
+    int                 dimensionYIndex = -1;
+    QString             colorDatasetId;
+    int                 colorPointDatasetDimensionIndex = -1;
+    QString             colormapSelectedVal;
+    float               lowerColorLimit = 0.0f;
+    float               upperColorLimit = 0.0f;
+
+    bool operator==(const LinePlotSourceKey&) const = default;
+};
+
+// Dataset columns a pipeline run reads, copied on the GUI thread
+// The worker never touches the datasets themselves, which the GUI thread may change or delete during a run
+struct LinePlotSource {
+    LinePlotSourceKey   key;
+    LineSeries          data;           // X/Y columns in dataset order
+    LineCategories      categories;     // Per-point categories from the color dataset, may be empty
+};
+
+// Overlay dimensions a pipeline run reads, copied on the GUI thread like LinePlotSource
+struct LinePlotOverlaySource {
+    QString             pointDatasetId;
+    quint64             pointDatasetRevision = 0;
+    std::vector<int>    dimensionIndices;
+    std::vector<float>  columns;        // Column-major, one column per entry of dimensionIndices, in dataset order
+};
+
+// Smoothing settings, each filter reads the ones it needs
+struct SmoothingParameters {
+    int     windowSize = 5;
+    int     polynomialOrder = 2;        // Savitzky-Golay
+    int     derivativeOrder = 0;        // Savitzky-Golay
+    float   quantile = 0.5f;            // Running quantile
+    float   splineBandwidth = 0.0f;     // Cubic spline, in point spacings, 0 interpolates
+    int     sampleCount = 0;            // Cubic spline, evenly spaced output points, 0 evaluates at the data X
+    float   xWindowWidth = 1.0f;        // X-window smoothers, window width in X units
+    float   lowessSpan = 0.1f;          // LOWESS, fraction of the points in each neighborhood
+    int     robustnessIterations = 2;   // LOWESS
+    int     lowessGridSize = 1000;      // LOWESS, evaluation points, 0 evaluates at every point
+
+    bool operator==(const SmoothingParameters&) const = default;
+};
+
+// Snapshot of everything a pipeline run needs, taken on the GUI thread
+struct LinePlotRequest {
+    quint64             generation = 0;
+    std::shared_ptr<const LinePlotSource> source;
+    std::shared_ptr<const LinePlotOverlaySource> overlaySource;
+    QString             pointDatasetId;
+    quint64             pointDatasetRevision = 0;
+    QString             colorDatasetId;
+    int                 dimensionXIndex = -1;
+    int                 dimensionYIndex = -1;
+    int                 colorPointDatasetDimensionIndex = -1;
+    QString             colormapSelectedVal;
+    float               lowerColorLimit = 0.0f;
+    float               upperColorLimit = 0.0f;
+    bool                switchAxes = false;
+    SmoothingType       smoothing = SmoothingType::None;
+    SmoothingParameters smoothingParameters;
+    NormalizationType   normalization = NormalizationType::None;
+    StatLineType        statLineType = StatLineType::LeastSquares;
+    bool                showStatLine = false;       // The stat line is only fitted while shown
+    ChangePointCost     changePointCost = ChangePointCost::None;
+    float               changePointPenalty = 2.0f;  // Per change, in units of log(n)
+    XAggregation        xAggregation = XAggregation::None;
+    float               xBinWidth = 0.0f;           // 0 groups equal X values
+    QString             selectedDimensionX;
+    QString             selectedDimensionY;
+    QString             titleText;
+    QString             sortAxisValue;
+    std::vector<int>    overlayDimensionIndices;    // Further Y dimensions smoothed against the same X ordering
+    QStringList         overlayDimensionNames;
+};
+
+// Output of a pipeline run, handed back to the GUI thread
+// The series are shared with the pipeline cache and never modified once published
+struct LinePlotResult {
+    quint64                                 generation = 0;
+    bool                                    cancelled = false;
+    std::shared_ptr<const LineSeries>       points;
+    std::shared_ptr<const LineSeries>       originalPoints;
+    std::shared_ptr<const LineCategories>   categories;
+    QVariantMap                             statLine;
+    std::vector<float>                      changePoints;       // X positions of the detected change points
+    std::shared_ptr<const LineSeries>       rangeLower;         // Y range of every X group while aggregating by X, otherwise null
+    std::shared_ptr<const LineSeries>       rangeUpper;
+    QRectF                                  originalBounds;     // X/Y range of originalPoints
+    std::vector<std::shared_ptr<const LineSeries>> overlays;    // One per overlay dimension, in request order
+    QStringList                             overlayNames;
+    QString                                 title;
+    QString                                 xAxisName;
+    QString                                 yAxisName;
+};
+
 // Normalization and smoothing utilities
-QVector<QPair<float, float>> applyNormalization(
-    const QVector<QPair<float, float>>& data,
-    NormalizationType type);
-
-QVector<QPair<float, float>> applyMovingAverage(const QVector<QPair<float, float>>& data, int windowSize);
-QVector<QPair<float, float>> applySavitzkyGolay(const QVector<QPair<float, float>>& data, int windowSize);
-QVector<QPair<float, float>> applyGaussian(const QVector<QPair<float, float>>& data, int windowSize);
-QVector<QPair<float, float>> applyExponentialMovingAverage(const QVector<QPair<float, float>>& data, float alpha = 0.2f);
-QVector<QPair<float, float>> applyRunningMedian(const QVector<QPair<float, float>>& data, int windowSize);
-QVector<QPair<float, float>> applyLinearInterpolation(const QVector<QPair<float, float>>& data, int step);
-QVector<QPair<float, float>> applyCubicSplineApproximation(const QVector<QPair<float, float>>& data);
-QVector<QPair<float, float>> applyMinMaxSampling(const QVector<QPair<float, float>>& data, int windowSize);
-
-//  utility for sorting and category sync
+// All stages read a LineSeries and write into a caller-provided one, so buffers can be reused between runs
+// Normalization may run in place and can hand back the statistics of its output without another pass
+// The robust modes use robustStatistics when given, so callers can cache them, and compute them otherwise
+void applyNormalization(
+    const LineSeries& data,
+    NormalizationType type,
+    LineSeries& result,
+    SeriesStatistics* statistics = nullptr,
+    const SeriesRobustStatistics* robustStatistics = nullptr);
+
+// Applies the Y half of applyNormalization() to a single column, gathering only the statistics the mode needs
+// result may be values itself
+void applyColumnNormalization(const float* values, std::size_t count, NormalizationType type, float* result);
+
+// The kernels taking a workspace keep their scratch buffers in it when one is given
+void applyMovingAverage(const LineSeries& data, int windowSize, LineSeries& smoothed, SmoothingWorkspace* workspace = nullptr);
+void applySavitzkyGolay(const LineSeries& data, int windowSize, int polynomialOrder, int derivativeOrder, LineSeries& smoothed);
+void applyGaussian(const LineSeries& data, int windowSize, LineSeries& smoothed, SmoothingWorkspace* workspace = nullptr);
+void applyExponentialMovingAverage(const LineSeries& data, LineSeries& smoothed, float alpha = 0.2f);
+void applyRunningMedian(const LineSeries& data, int windowSize, LineSeries& smoothed, SmoothingWorkspace* workspace = nullptr);
+void applyRunningQuantile(const LineSeries& data, int windowSize, float quantile, LineSeries& smoothed, SmoothingWorkspace* workspace = nullptr);
+void applyLinearInterpolation(const LineSeries& data, int step, LineSeries& interpolated);
+void applyCubicSpline(const LineSeries& data, float bandwidth, int sampleCount, LineSeries& smoothed);
+void applyMinMaxSampling(const LineSeries& data, int windowSize, LineSeries& result);
+
+//  utility for sorting and category sync, permutation receives the source index of every sorted point
+//  with switchAxes the Y column of rawData becomes the X column of sortedData and vice versa
 void sortDataAndCategories(
-    const QVector<QPair<float, float>>& rawData,
-    const QVector<QPair<QString, QColor>>& categoryValues,
-    QVector<QPair<float, float>>& sortedData,
-    QVector<QPair<QString, QColor>>& sortedCategories);
-
-//  statLine calculation utility
-QVariantMap calculateStatLine(const QVector<QPair<float, float>>& normalizedData);
-
-//  payload construction utility
-QVariantList buildPayload(
-    const QVector<QPair<float, float>>& smoothedData,
-    const QVector<QPair<QString, QColor>>& sortedCategories);
-
-//  general-purpose data preparation utility
-QVariant prepareData(
-    QVector<float>& coordvalues,
-    QVector<QPair<QString, QColor>>& categoryValues,
-    SmoothingType smoothing,
-    int smoothingParam,
-    NormalizationType normalization,
+    const LineSeries& rawData,
+    const LineCategories& categoryValues,
+    bool switchAxes,
+    LineSeries& sortedData,
+    LineCategories& sortedCategories,
+    SortPermutation& permutation,
+    QString axis);
+
+//  statLine calculation utility, from the statistics of the normalized data
+QVariantMap calculateStatLine(const SeriesStatistics& statistics);
+
+//  statLine of a fitted trend across the X range, with the fan of its 95% slope interval
+QVariantMap calculateTrendStatLine(const TrendLine& trend, const SeriesStatistics& statistics, const QString& name);
+
+//  chart title, falls back to "X vs Y" when no title is set
+QString buildChartTitle(
     const QString& selectedDimensionX,
     const QString& selectedDimensionY,
-    const QString& titleText,
-    const QString& sortAxisValue
-);
+    const QString& titleText);
 
-// Utility to extract coordvalues and categoryValues from dataset and cluster info
+// Utility to extract the X/Y columns and categoryValues from dataset and cluster info
+// Reads the datasets, so it must run on the GUI thread
 void extractLinePlotData(
-    const mv::Dataset<Points>& currentDataSet,
+    const Points* currentDataSet,
     int dimensionXIndex,
     int dimensionYIndex,
-    QString colorDatasetID,
+    DatasetImpl* colorDataset,
     int colorPointDatasetDimensionIndex,
     QString colormapSelectedVal, 
     float minValue,
     float maxValue,
-    QVector<float>& coordvalues,
-    QVector<QPair<QString, QColor>>& categoryValues
-);
\ No newline at end of file
+    LineSeries& lineData,
+    LineCategories& categoryValues
+);
+
+// Utility to copy dimensions into a column-major block in dataset order
+// Reads the dataset, so it must run on the GUI thread
+void extractColumns(
+    const Points* currentDataSet,
+    const std::vector<int>& dimensionIndices,
+    std::vector<float>& columns
+);
+
+// Utility to reorder a column-major block of numColumns columns, row i of columns holds row permutation[i] of sourceColumns
+void gatherSortedColumns(
+    const std::vector<float>& sourceColumns,
+    std::size_t numColumns,
+    const SortPermutation& permutation,
+    std::vector<float>& columns
+);
@@ -3,6 +3,8 @@
 #include "ChartWidget.h"
 #include "../libs/LineChartLib/LineChartWidget.h"
 #include "LinePlotUtils.h"
+#include "LinePlotPipeline.h"
+#include "SmoothingFilters.h"
 
 #include <DatasetsMimeData.h>
 #include <QApplication> 
@@ -17,6 +19,7 @@
 #include <QMimeData>
 #include <QDebug>
 #include<QtConcurrent>
+#include <QFutureWatcher>
 
 Q_PLUGIN_METADATA(IID "studio.manivault.LinePlotViewPlugin")
 
@@ -25,11 +28,22 @@ using namespace mv;
 LinePlotViewPlugin::LinePlotViewPlugin(const PluginFactory* factory) :
     ViewPlugin(factory),
     _chartWidget(nullptr),
+    _lineChartWidget(nullptr),
     //_dropWidget(nullptr),
     _settingsAction(*this),
-    _currentDataSet(nullptr)
+    _currentDataSet(nullptr),
+    _pipeline(std::make_shared<LinePlotPipeline>())
 {
     getLearningCenterAction().addVideos(QStringList({ "Practitioner", "Developer" }));
+
+    // Pipeline runs are serialized; a new run cancels the one in flight
+    _pipelineThreadPool.setMaxThreadCount(1);
+}
+
+LinePlotViewPlugin::~LinePlotViewPlugin()
+{
+    _pipelineCancellation.cancel();
+    _pipelineThreadPool.waitForDone();
 }
 
 void LinePlotViewPlugin::init()
@@ -52,6 +66,7 @@ void LinePlotViewPlugin::init()
     {
         _lineChartWidget = new LineChartWidget(&getWidget());
         layout->addWidget(_lineChartWidget, 1);
+        connect(_lineChartWidget, &LineChartWidget::plotWidthChanged, this, &LinePlotViewPlugin::plotWidthChanged);
         //_dropWidget = new DropWidget(_lineChartWidget);
     }
     else
@@ -59,6 +74,7 @@ void LinePlotViewPlugin::init()
         _chartWidget = new ChartWidget(this);
         _chartWidget->setPage(":line_chart/line_chart.html", "qrc:/line_chart/");
         layout->addWidget(_chartWidget, 1);
+        connect(_chartWidget, &ChartWidget::plotWidthChanged, this, &LinePlotViewPlugin::plotWidthChanged);
         //_dropWidget = new DropWidget(_chartWidget);
     }
     
@@ -110,6 +126,9 @@ void LinePlotViewPlugin::init()
      _dimensionYRangeDebounceTimer.setSingleShot(true);
      _smoothingTypeDebounceTimer.setSingleShot(true);
      _normalizationTypeDebounceTimer.setSingleShot(true);
+     _statLineTypeDebounceTimer.setSingleShot(true);
+     _changePointDebounceTimer.setSingleShot(true);
+     _xAggregationDebounceTimer.setSingleShot(true);
      _smoothingWindowDebounceTimer.setSingleShot(true);
      _colorDatasetDebounceTimer.setSingleShot(true);
      _colorPointDatasetDimensionDebounceTimer.setSingleShot(true);
@@ -118,13 +137,11 @@ void LinePlotViewPlugin::init()
 
 
     const auto dataChanged = [this]() -> void {
+        // Cached pipeline stages of the previous revision are no longer valid
+        ++_pointDatasetRevision;
         _isUpdating = true;
         dataConvertChartUpdate();
         _isUpdating = false;
-        /*QtConcurrent::run([this]() {
-            dataConvertChartUpdate();
-            _isUpdating = false;
-            });*/
         };
 
     connect(&_currentDataSet, &Dataset<Points>::dataChanged, this, dataChanged);
@@ -145,6 +162,8 @@ void LinePlotViewPlugin::init()
             //_dropWidget->setShowDropIndicator(false);
             _settingsAction.getDatasetOptionsHolder().getDataDimensionXSelectionAction().setPointsDataset(_currentDataSet);
             _settingsAction.getDatasetOptionsHolder().getDataDimensionYSelectionAction().setPointsDataset(_currentDataSet);
+            const auto dimensionNames = _currentDataSet->getDimensionNames();
+            _settingsAction.getDatasetOptionsHolder().getOverlayDimensionsAction().setOptions(QStringList(dimensionNames.begin(), dimensionNames.end()));
             if (_currentDataSet->getNumDimensions() >= 2)
             {
                 _settingsAction.getDatasetOptionsHolder().getDataDimensionXSelectionAction().setCurrentDimensionIndex(0);
@@ -209,6 +228,7 @@ void LinePlotViewPlugin::init()
             _settingsAction.getDatasetOptionsHolder().getDataDimensionYSelectionAction().setPointsDataset(_currentDataSet);
             _settingsAction.getDatasetOptionsHolder().getDataDimensionXSelectionAction().setCurrentDimensionIndex(-1);
             _settingsAction.getDatasetOptionsHolder().getDataDimensionYSelectionAction().setCurrentDimensionIndex(-1);
+            _settingsAction.getDatasetOptionsHolder().getOverlayDimensionsAction().setOptions({});
             _settingsAction.getDatasetOptionsHolder().getColorDatasetAction().setDatasets({});
             
         }
@@ -227,14 +247,72 @@ void LinePlotViewPlugin::init()
         };
     connect(&_settingsAction.getChartOptionsHolder().getShowEnvelopeAction(), &ToggleAction::toggled, this, showEnvelopeChanged);
 
+    // The trend line is only fitted while it is shown
     const auto showStatLineChanged = [this]() {
         if (_lineChartWidget)
         {
             _lineChartWidget->setShowStatLine(_settingsAction.getChartOptionsHolder().getShowStatLineAction().isChecked());
         }
+        _statLineTypeDebounceTimer.start(50);
         };
     connect(&_settingsAction.getChartOptionsHolder().getShowStatLineAction(), &ToggleAction::toggled, this, showStatLineChanged);
 
+    connect(&_settingsAction.getChartOptionsHolder().getStatLineTypeAction(),
+        &OptionAction::currentIndexChanged,
+        this,
+        [this]() {
+            _statLineTypeDebounceTimer.start(50);
+        });
+
+    connect(&_statLineTypeDebounceTimer, &QTimer::timeout, this, [this]() {
+        updateChartTrigger();
+        });
+
+    connect(&_settingsAction.getChartOptionsHolder().getChangePointCostAction(),
+        &OptionAction::currentIndexChanged,
+        this,
+        [this]() {
+            _changePointDebounceTimer.start(50);
+        });
+
+    connect(&_settingsAction.getChartOptionsHolder().getChangePointPenaltyAction(),
+        &DecimalAction::valueChanged,
+        this,
+        [this]() {
+            _changePointDebounceTimer.start(50);
+        });
+
+    connect(&_changePointDebounceTimer, &QTimer::timeout, this, [this]() {
+        updateChartTrigger();
+        });
+
+    connect(&_settingsAction.getChartOptionsHolder().getXAggregationAction(),
+        &OptionAction::currentIndexChanged,
+        this,
+        [this]() {
+            _xAggregationDebounceTimer.start(50);
+        });
+
+    connect(&_settingsAction.getChartOptionsHolder().getXBinWidthAction(),
+        &DecimalAction::valueChanged,
+        this,
+        [this]() {
+            _xAggregationDebounceTimer.start(50);
+        });
+
+    connect(&_xAggregationDebounceTimer, &QTimer::timeout, this, [this]() {
+        updateChartTrigger();
+        });
+
+    const auto downsamplingModeChanged = [this]() {
+        if (_lineChartWidget)
+        {
+            const bool lttb = _settingsAction.getChartOptionsHolder().getDownsamplingModeAction().getCurrentText() == "LTTB";
+            _lineChartWidget->setLodMode(lttb ? LineLod::Mode::Lttb : LineLod::Mode::M4);
+        }
+        };
+    connect(&_settingsAction.getChartOptionsHolder().getDownsamplingModeAction(), &OptionAction::currentIndexChanged, this, downsamplingModeChanged);
+
     const auto sortAxesChanged = [this]() {updateChartTrigger(); };
     connect(&_settingsAction.getChartOptionsHolder().getSortByAxisAction(), &OptionAction::currentIndexChanged, this, sortAxesChanged);
 
@@ -389,6 +467,13 @@ void LinePlotViewPlugin::init()
         updateChartTrigger();
         });
 
+    connect(&_settingsAction.getDatasetOptionsHolder().getOverlayDimensionsAction(),
+        &OptionsAction::selectedOptionsChanged,
+        this,
+        [this]() {
+            _dimensionYRangeDebounceTimer.start(50);
+        });
+
 
 
 
@@ -422,6 +507,62 @@ void LinePlotViewPlugin::init()
              _smoothingWindowDebounceTimer.start(50);
          });
 
+     connect(&_settingsAction.getChartOptionsHolder().getPolynomialOrderAction(),
+         &IntegralAction::valueChanged,
+         this,
+         [this]() {
+             _smoothingWindowDebounceTimer.start(50);
+         });
+
+     connect(&_settingsAction.getChartOptionsHolder().getDerivativeOrderAction(),
+         &IntegralAction::valueChanged,
+         this,
+         [this]() {
+             _smoothingWindowDebounceTimer.start(50);
+         });
+
+     connect(&_settingsAction.getChartOptionsHolder().getQuantileAction(),
+         &DecimalAction::valueChanged,
+         this,
+         [this]() {
+             _smoothingWindowDebounceTimer.start(50);
+         });
+
+     connect(&_settingsAction.getChartOptionsHolder().getSplineBandwidthAction(),
+         &DecimalAction::valueChanged,
+         this,
+         [this]() {
+             _smoothingWindowDebounceTimer.start(50);
+         });
+
+     connect(&_settingsAction.getChartOptionsHolder().getXWindowWidthAction(),
+         &DecimalAction::valueChanged,
+         this,
+         [this]() {
+             _smoothingWindowDebounceTimer.start(50);
+         });
+
+     connect(&_settingsAction.getChartOptionsHolder().getLowessSpanAction(),
+         &DecimalAction::valueChanged,
+         this,
+         [this]() {
+             _smoothingWindowDebounceTimer.start(50);
+         });
+
+     connect(&_settingsAction.getChartOptionsHolder().getRobustnessIterationsAction(),
+         &IntegralAction::valueChanged,
+         this,
+         [this]() {
+             _smoothingWindowDebounceTimer.start(50);
+         });
+
+     connect(&_settingsAction.getChartOptionsHolder().getLowessGridSizeAction(),
+         &IntegralAction::valueChanged,
+         this,
+         [this]() {
+             _smoothingWindowDebounceTimer.start(50);
+         });
+
      connect(&_smoothingWindowDebounceTimer, &QTimer::timeout, this, [this]() {
          updateChartTrigger();
          });
@@ -437,10 +578,18 @@ void LinePlotViewPlugin::initTrigger()
     _isUpdating = true;
     dataConvertChartUpdate();
     _isUpdating = false;
-    /*QtConcurrent::run([this]() {
-        dataConvertChartUpdate();
-        _isUpdating = false;
-        });*/
+}
+
+void LinePlotViewPlugin::plotWidthChanged(int width)
+{
+    if (width == _plotWidth)
+        return;
+
+    // Only resampling filters depend on the plot resolution
+    _plotWidth = width;
+    const auto smoothing = smoothingTypeFromName(_settingsAction.getChartOptionsHolder().getSmoothingTypeAction().getCurrentText());
+    if (smoothing && smoothingFilterReads(*smoothing, SmoothingParameter::SampleCount))
+        _smoothingWindowDebounceTimer.start(50);
 }
 
 void LinePlotViewPlugin::updateChartTrigger()
@@ -456,10 +605,6 @@ void LinePlotViewPlugin::updateChartTrigger()
         _isUpdating = true;
         dataConvertChartUpdate();
         _isUpdating = false;
-       /* QtConcurrent::run([this]() {
-            dataConvertChartUpdate();
-            _isUpdating = false;
-            });*/
     }
 }
 
@@ -484,159 +629,254 @@ void LinePlotViewPlugin::loadData(const mv::Datasets& datasets)
 
 void LinePlotViewPlugin::dataConvertChartUpdate()
 {
-    QVariant root;
+    // A new request supersedes whatever is still running
+    _pipelineCancellation.cancel();
+    _pipelineCancellation = CancellationToken();
+    const auto generation = ++_pipelineGeneration;
+
     if (!_currentDataSet.isValid())
     {
         qWarning() << "LinePlotViewPlugin::convertDataAndUpdateChart: No valid dataset to convert";
+        _source.reset();
+        _overlaySource.reset();
+        presentChartData(LinePlotResult());
+        return;
     }
-    else
-    {
-        //FunctionTimer timer(Q_FUNC_INFO);
 
-        const auto numPoints = _currentDataSet->getNumPoints();
-        const auto numDimensions = _currentDataSet->getNumDimensions();
-        const auto dimensionNames = _currentDataSet->getDimensionNames();
+    //FunctionTimer timer(Q_FUNC_INFO);
 
-        //qDebug() << "dataConvertChartUpdate: numPoints =" << numPoints << " numDimensions =" << numDimensions;
-        auto selectedDimensionX = _settingsAction.getDatasetOptionsHolder().getDataDimensionXSelectionAction().getCurrentDimensionName();
-        auto selectedDimensionY = _settingsAction.getDatasetOptionsHolder().getDataDimensionYSelectionAction().getCurrentDimensionName();
-        //qDebug() << "dataConvertChartUpdate: selectedDimensionX =" << selectedDimensionX << " selectedDimensionY =" << selectedDimensionY;
+    const auto numDimensions = _currentDataSet->getNumDimensions();
+    const auto dimensionNames = _currentDataSet->getDimensionNames();
 
-        int dimensionXIndex = -1;
-        int dimensionYIndex = -1;
-        if (selectedDimensionX.isEmpty() || selectedDimensionY.isEmpty()) {
-            return;
-        }
-        for (int i = 0; i < numDimensions; ++i) {
-            if (dimensionNames[i] == selectedDimensionX) {
-                dimensionXIndex = i;
-            }
-            if (dimensionNames[i] == selectedDimensionY) {
-                dimensionYIndex = i;
-            }
-        }
-        //qDebug() << "dataConvertChartUpdate: dimensionXIndex =" << dimensionXIndex << " dimensionYIndex =" << dimensionYIndex;
+    //qDebug() << "dataConvertChartUpdate: numPoints =" << numPoints << " numDimensions =" << numDimensions;
+    auto selectedDimensionX = _settingsAction.getDatasetOptionsHolder().getDataDimensionXSelectionAction().getCurrentDimensionName();
+    auto selectedDimensionY = _settingsAction.getDatasetOptionsHolder().getDataDimensionYSelectionAction().getCurrentDimensionName();
+    //qDebug() << "dataConvertChartUpdate: selectedDimensionX =" << selectedDimensionX << " selectedDimensionY =" << selectedDimensionY;
 
-        if (dimensionXIndex == -1 || dimensionYIndex == -1) {
-            qCritical() << "LinePlotViewPlugin::convertDataAndUpdateChart: Selected dimensions not found in dataset";
-            return;
+    int dimensionXIndex = -1;
+    int dimensionYIndex = -1;
+    if (selectedDimensionX.isEmpty() || selectedDimensionY.isEmpty()) {
+        return;
+    }
+    for (int i = 0; i < numDimensions; ++i) {
+        if (dimensionNames[i] == selectedDimensionX) {
+            dimensionXIndex = i;
         }
+        if (dimensionNames[i] == selectedDimensionY) {
+            dimensionYIndex = i;
+        }
+    }
+    //qDebug() << "dataConvertChartUpdate: dimensionXIndex =" << dimensionXIndex << " dimensionYIndex =" << dimensionYIndex;
 
-        QVector<float> coordvalues;
-        QVector<QPair<QString, QColor>> categoryValues;
-
-        Dataset colorDataset = _settingsAction.getDatasetOptionsHolder().getColorDatasetAction().getCurrentDataset();
-        int colorPointDatasetDimensionIndex = -1;
-        QString colormapselectedVal="";
-        float lowerColorLimit = _settingsAction.getChartOptionsHolder().getLowerColorLimitAction().getValue();
-        float upperColorLimit = _settingsAction.getChartOptionsHolder().getUpperColorLimitAction().getValue();
+    if (dimensionXIndex == -1 || dimensionYIndex == -1) {
+        qCritical() << "LinePlotViewPlugin::convertDataAndUpdateChart: Selected dimensions not found in dataset";
+        return;
+    }
 
+    LinePlotRequest request;
+    request.generation = generation;
+    request.pointDatasetId = _currentDataSet->getId();
+    request.pointDatasetRevision = _pointDatasetRevision;
+    request.dimensionXIndex = dimensionXIndex;
+    request.dimensionYIndex = dimensionYIndex;
+    request.selectedDimensionX = selectedDimensionX;
+    request.selectedDimensionY = selectedDimensionY;
+    request.lowerColorLimit = _settingsAction.getChartOptionsHolder().getLowerColorLimitAction().getValue();
+    request.upperColorLimit = _settingsAction.getChartOptionsHolder().getUpperColorLimitAction().getValue();
+    request.switchAxes = _settingsAction.getChartOptionsHolder().getSwitchAxesAction().isChecked();
+
+    Dataset colorDataset = _settingsAction.getDatasetOptionsHolder().getColorDatasetAction().getCurrentDataset();
+    if (colorDataset.isValid())
+    {
+        request.colorDatasetId = colorDataset->getId();
         if (colorDataset->getDataType() == PointType)
         {
-            colorPointDatasetDimensionIndex = _settingsAction.getDatasetOptionsHolder().getColorPointDatasetDimensionAction().getCurrentDimensionIndex();
-            colormapselectedVal = _settingsAction.getChartOptionsHolder().getPointDatasetDimensionColorMapAction().getColorMap();
+            request.colorPointDatasetDimensionIndex = _settingsAction.getDatasetOptionsHolder().getColorPointDatasetDimensionAction().getCurrentDimensionIndex();
+            request.colormapSelectedVal = _settingsAction.getChartOptionsHolder().getPointDatasetDimensionColorMapAction().getColorMap();
         }
+    }
 
+    // The worker only reads a copy of the columns; it is retaken when the data or the columns change
+    const LinePlotSourceKey sourceKey{
+        request.pointDatasetId,
+        request.pointDatasetRevision,
+        request.dimensionXIndex,
+        request.dimensionYIndex,
+        request.colorDatasetId,
+        request.colorPointDatasetDimensionIndex,
+        request.colormapSelectedVal,
+        request.lowerColorLimit,
+        request.upperColorLimit
+    };
+    if (!_source || !(_source->key == sourceKey)) {
+        auto source = std::make_shared<LinePlotSource>();
+        source->key = sourceKey;
         extractLinePlotData(
-            _currentDataSet,
-            dimensionXIndex,
-            dimensionYIndex,
-            colorDataset->getId(),
-            colorPointDatasetDimensionIndex,
-            colormapselectedVal,
-            lowerColorLimit,
-            upperColorLimit,
-            coordvalues,
-            categoryValues
+            _currentDataSet.get(),
+            sourceKey.dimensionXIndex,
+            sourceKey.dimensionYIndex,
+            colorDataset.isValid() ? colorDataset.get() : nullptr,
+            sourceKey.colorPointDatasetDimensionIndex,
+            sourceKey.colormapSelectedVal,
+            sourceKey.lowerColorLimit,
+            sourceKey.upperColorLimit,
+            source->data,
+            source->categories
         );
+        _source = std::move(source);
+    }
+    request.source = _source;
+
+    const QString smoothingText = _settingsAction.getChartOptionsHolder().getSmoothingTypeAction().getCurrentText();
+    const auto smoothing = smoothingTypeFromName(smoothingText);
+    if (!smoothing)
+        qCritical() << "LinePlotViewPlugin::convertDataAndUpdateChart: Unknown smoothing type, defaulting to None";
+    request.smoothing = smoothing.value_or(SmoothingType::None);
+    request.smoothingParameters.windowSize = _settingsAction.getChartOptionsHolder().getSmoothingWindowAction().getValue();
+    request.smoothingParameters.polynomialOrder = _settingsAction.getChartOptionsHolder().getPolynomialOrderAction().getValue();
+    request.smoothingParameters.derivativeOrder = _settingsAction.getChartOptionsHolder().getDerivativeOrderAction().getValue();
+    request.smoothingParameters.quantile = _settingsAction.getChartOptionsHolder().getQuantileAction().getValue();
+    request.smoothingParameters.splineBandwidth = _settingsAction.getChartOptionsHolder().getSplineBandwidthAction().getValue();
+    request.smoothingParameters.sampleCount = _plotWidth;
+    request.smoothingParameters.xWindowWidth = _settingsAction.getChartOptionsHolder().getXWindowWidthAction().getValue();
+    request.smoothingParameters.lowessSpan = _settingsAction.getChartOptionsHolder().getLowessSpanAction().getValue();
+    request.smoothingParameters.robustnessIterations = _settingsAction.getChartOptionsHolder().getRobustnessIterationsAction().getValue();
+    request.smoothingParameters.lowessGridSize = _settingsAction.getChartOptionsHolder().getLowessGridSizeAction().getValue();
+
+    NormalizationType normalization = NormalizationType::None;
+    const QString normalizationText = _settingsAction.getChartOptionsHolder().getNormalizationTypeAction().getCurrentText();
+    if (normalizationText == "None") {
+        normalization = NormalizationType::None;
+    }
+    else if (normalizationText == "Z-Score") {
+        normalization = NormalizationType::ZScore;
+    }
+    else if (normalizationText == "Min-Max") {
+        normalization = NormalizationType::MinMax;
+    }
+    else if (normalizationText == "DecimalScaling") {
+        normalization = NormalizationType::DecimalScaling;
+    }
+    else if (normalizationText == "Median/MAD") {
+        normalization = NormalizationType::MedianMad;
+    }
+    else if (normalizationText == "Quantile Clip (1-99%)") {
+        normalization = NormalizationType::QuantileClip;
+    }
+    else {
+        qCritical() << "LinePlotViewPlugin::convertDataAndUpdateChart: Unknown normalization type, defaulting to None";
+        normalization = NormalizationType::None;
+    }
+    request.normalization = normalization;
 
-        if (_settingsAction.getChartOptionsHolder().getSwitchAxesAction().isChecked()) {
-            for (int i = 0; i + 1 < coordvalues.size(); i += 2) {
-                std::swap(coordvalues[i], coordvalues[i + 1]);
-            }
-            std::swap(selectedDimensionX, selectedDimensionY);
-        }
-
-        SmoothingType smoothing = SmoothingType::None;
-        const QString smoothingText = _settingsAction.getChartOptionsHolder().getSmoothingTypeAction().getCurrentText();
-        if (smoothingText == "None") {
-            smoothing = SmoothingType::None;
-        }
-        else if (smoothingText == "Moving Average") {
-            smoothing = SmoothingType::MovingAverage;
-        }
-        else if (smoothingText == "Savitzky-Golay") {
-            smoothing = SmoothingType::SavitzkyGolay;
-        }
-        else if (smoothingText == "Gaussian") {
-            smoothing = SmoothingType::Gaussian;
-        }
-        else if (smoothingText == "Exponential Moving Average") {
-            smoothing = SmoothingType::ExponentialMovingAverage;
-        }
-        else if (smoothingText == "Cubic Spline") {
-            smoothing = SmoothingType::CubicSpline;
-        }
-        else if (smoothingText == "Linear Interpolation") {
-            smoothing = SmoothingType::LinearInterpolation;
-        }
-        else if (smoothingText == "Min-Max Sampling") {
-            smoothing = SmoothingType::MinMaxSampling;
-        }
-        else if (smoothingText == "Running Median") {
-            smoothing = SmoothingType::RunningMedian;
-        }
-        else {
-            qCritical() << "LinePlotViewPlugin::convertDataAndUpdateChart: Unknown smoothing type, defaulting to None";
-            smoothing = SmoothingType::None;
-        }
+    const QString statLineText = _settingsAction.getChartOptionsHolder().getStatLineTypeAction().getCurrentText();
+    if (statLineText == "Two Means") {
+        request.statLineType = StatLineType::TwoMeans;
+    }
+    else if (statLineText == "Least Squares") {
+        request.statLineType = StatLineType::LeastSquares;
+    }
+    else if (statLineText == "Theil-Sen") {
+        request.statLineType = StatLineType::TheilSen;
+    }
+    else {
+        qCritical() << "LinePlotViewPlugin::convertDataAndUpdateChart: Unknown stat line type, defaulting to Least Squares";
+        request.statLineType = StatLineType::LeastSquares;
+    }
+    request.showStatLine = _settingsAction.getChartOptionsHolder().getShowStatLineAction().isChecked();
 
-        int windowSize = _settingsAction.getChartOptionsHolder().getSmoothingWindowAction().getValue();
-        NormalizationType normalization = NormalizationType::None;
-        const QString normalizationText = _settingsAction.getChartOptionsHolder().getNormalizationTypeAction().getCurrentText();
-        if (normalizationText == "None") {
-            normalization = NormalizationType::None;
-        }
-        else if (normalizationText == "Z-Score") {
-            normalization = NormalizationType::ZScore;
-        }
-        else if (normalizationText == "Min-Max") {
-            normalization = NormalizationType::MinMax;
-        }
-        else if (normalizationText == "DecimalScaling") {
-            normalization = NormalizationType::DecimalScaling;
-        }
-        else {
-            qCritical() << "LinePlotViewPlugin::convertDataAndUpdateChart: Unknown normalization type, defaulting to None";
-            normalization = NormalizationType::None;
-        }
+    const QString changePointText = _settingsAction.getChartOptionsHolder().getChangePointCostAction().getCurrentText();
+    if (changePointText == "Mean") {
+        request.changePointCost = ChangePointCost::Mean;
+    }
+    else if (changePointText == "Mean and Variance") {
+        request.changePointCost = ChangePointCost::MeanVariance;
+    }
+    else {
+        request.changePointCost = ChangePointCost::None;
+    }
+    request.changePointPenalty = _settingsAction.getChartOptionsHolder().getChangePointPenaltyAction().getValue();
 
-        QString titleText = _settingsAction.getChartOptionsHolder().getChartTitleAction().getString();
-        QString sortAxisValue = _settingsAction.getChartOptionsHolder().getSortByAxisAction().getCurrentText();
-
-        root = ::prepareData(
-            coordvalues,
-            categoryValues,
-            smoothing,
-            windowSize,
-            normalization,
-            selectedDimensionX,
-            selectedDimensionY,
-            titleText,
-            sortAxisValue
-        );
+    const QString xAggregationText = _settingsAction.getChartOptionsHolder().getXAggregationAction().getCurrentText();
+    if (xAggregationText == "Mean") {
+        request.xAggregation = XAggregation::Mean;
+    }
+    else if (xAggregationText == "Median") {
+        request.xAggregation = XAggregation::Median;
+    }
+    else if (xAggregationText == "Min") {
+        request.xAggregation = XAggregation::Minimum;
+    }
+    else if (xAggregationText == "Max") {
+        request.xAggregation = XAggregation::Maximum;
+    }
+    else if (xAggregationText == "Count") {
+        request.xAggregation = XAggregation::Count;
+    }
+    else {
+        request.xAggregation = XAggregation::None;
+    }
+    request.xBinWidth = _settingsAction.getChartOptionsHolder().getXBinWidthAction().getValue();
+
+    request.titleText = _settingsAction.getChartOptionsHolder().getChartTitleAction().getString();
+    request.sortAxisValue = _settingsAction.getChartOptionsHolder().getSortByAxisAction().getCurrentText();
+
+    // Overlay dimensions, the main Y dimension is already drawn
+    for (const auto& overlayName : _settingsAction.getDatasetOptionsHolder().getOverlayDimensionsAction().getSelectedOptions()) {
+        const auto it = std::find(dimensionNames.begin(), dimensionNames.end(), overlayName);
+        if (it == dimensionNames.end() || overlayName == selectedDimensionY)
+            continue;
+        request.overlayDimensionIndices.push_back(static_cast<int>(std::distance(dimensionNames.begin(), it)));
+        request.overlayDimensionNames.append(overlayName);
+    }
+    if (!_overlaySource
+        || _overlaySource->pointDatasetId != request.pointDatasetId
+        || _overlaySource->pointDatasetRevision != request.pointDatasetRevision
+        || _overlaySource->dimensionIndices != request.overlayDimensionIndices) {
+        auto overlaySource = std::make_shared<LinePlotOverlaySource>();
+        overlaySource->pointDatasetId = request.pointDatasetId;
+        overlaySource->pointDatasetRevision = request.pointDatasetRevision;
+        overlaySource->dimensionIndices = request.overlayDimensionIndices;
+        extractColumns(_currentDataSet.get(), overlaySource->dimensionIndices, overlaySource->columns);
+        _overlaySource = std::move(overlaySource);
     }
+    request.overlaySource = _overlaySource;
 
+    // Run the pipeline on the worker pool; the watcher delivers the result back on the GUI thread
+    auto* watcher = new QFutureWatcher<LinePlotResult>(this);
+    connect(watcher, &QFutureWatcher<LinePlotResult>::finished, this, [this, watcher]() {
+        const LinePlotResult result = watcher->result();
+        watcher->deleteLater();
+
+        // Results of superseded or cancelled runs are dropped
+        if (result.cancelled || result.generation != _pipelineGeneration)
+            return;
+
+        presentChartData(result);
+        });
+
+    const CancellationToken cancellation = _pipelineCancellation;
+    const auto pipeline = _pipeline;
+    watcher->setFuture(QtConcurrent::run(&_pipelineThreadPool, [pipeline, request, cancellation]() {
+        return pipeline->run(request, cancellation);
+        }));
+}
+
+void LinePlotViewPlugin::presentChartData(const LinePlotResult& result)
+{
     if (_openGlEnabled)
     {
-        _lineChartWidget->setData(root.toMap());
-
+        _lineChartWidget->setOverlaySeries(result.overlays, result.overlayNames);
+        _lineChartWidget->setChangePoints(result.changePoints);
+        _lineChartWidget->setRangeBand(result.rangeLower, result.rangeUpper);
+        _lineChartWidget->setSeries(result.points, result.originalPoints, result.categories,
+            result.statLine, result.title, result.xAxisName, result.yAxisName, result.originalBounds);
     }
     else
     {
-        emit _chartWidget->getCommunicationObject().qt_js_setDataAndPlotInJS(root.toMap());
+        _chartWidget->setSeries(result.points, result.categories,
+            result.statLine, result.title, result.xAxisName, result.yAxisName);
     }
-   
 }
 
 /*void LinePlotViewPlugin::publishSelection(const std::vector<unsigned int>& selectedIDs)
@@ -673,6 +913,9 @@ LinePlotViewPluginFactory::LinePlotViewPluginFactory()
 {
     setIconByName("chart-line");
 
+    // Custom schemes are only honored when registered before the web engine starts
+    ChartDataSchemeHandler::registerScheme();
+
     getPluginMetadata().setDescription("Line Javascript view plugin");
     getPluginMetadata().setSummary("This plugin shows how to implement a basic Javascript-based view plugin in ManiVault Studio.");
     getPluginMetadata().setCopyrightHolder({ "BioVault (Biomedical Visual Analytics Unit LUMC - TU Delft)" });
@@ -6,7 +6,10 @@
 #include <PointData/PointData.h>
 #include <widgets/DropWidget.h>
 #include "SettingsAction.h"
+#include "CancellationToken.h"
 #include <QWidget>
+#include <QThreadPool>
+#include <memory>
 
 /** All plugin related classes are in the ManiVault plugin namespace */
 using namespace mv::plugin;
@@ -19,6 +22,10 @@ using namespace mv::util;
 
 class ChartWidget;
 class LineChartWidget;
+class LinePlotPipeline;
+struct LinePlotResult;
+struct LinePlotSource;
+struct LinePlotOverlaySource;
 enum class SmoothingType {
     None,
     MovingAverage,
@@ -28,13 +35,40 @@ enum class SmoothingType {
     CubicSpline,
     LinearInterpolation,
     MinMaxSampling,
-    RunningMedian
+    RunningMedian,
+    RunningQuantile,
+    XWindowMean,
+    XWindowMedian,
+    XWindowMinimum,
+    XWindowMaximum,
+    XWindowGaussian,
+    Lowess
 };
 enum class NormalizationType {
     None,
     ZScore,         // (x - mean) / stddev
     MinMax,         // (x - min) / (max - min)
-    DecimalScaling  // x / 10^j, where j makes max(abs(x)) < 1
+    DecimalScaling, // x / 10^j, where j makes max(abs(x)) < 1
+    MedianMad,      // (x - median) / (1.4826 * MAD)
+    QuantileClip    // x clamped to its 1st..99th percentile, then scaled to [0, 1]
+};
+enum class StatLineType {
+    TwoMeans,       // Between the means of the first and last half
+    LeastSquares,   // Ordinary least squares fit
+    TheilSen        // Median of the pairwise slopes, robust against outliers
+};
+enum class ChangePointCost {
+    None,
+    Mean,           // Shifts of the mean under a common variance
+    MeanVariance    // Shifts of mean and variance together
+};
+enum class XAggregation {
+    None,
+    Mean,
+    Median,
+    Minimum,
+    Maximum,
+    Count           // Number of points per X group
 };
 
 /**
@@ -64,8 +98,8 @@ public:
      */
     LinePlotViewPlugin(const PluginFactory* factory);
 
-    /** Destructor */
-    ~LinePlotViewPlugin() override = default;
+    /** Destructor, waits for a running pipeline to wind down */
+    ~LinePlotViewPlugin() override;
     
     /** This function is called by the core after the view plugin has been created */
     void init() override;
@@ -79,19 +113,19 @@ public slots:
     void dataConvertChartUpdate();
     void initTrigger();
 
+    /** Remembers the plot width and resamples filters that evaluate at plot resolution */
+    void plotWidthChanged(int width);
+
 private:
     /** Published selections received from the JS side to ManiVault's core */
     //void publishSelection(const std::vector<unsigned int>& selectedIDs);
 
     QString getCurrentDataSetID() const;
 
+    /** Hands a finished chart payload to the active chart widget, must be called on the GUI thread */
+    void presentChartData(const LinePlotResult& result);
+
 
-    QVariant prepareData(
-        QVector<float>& coordvalues,
-        QVector<QPair<QString, QColor>>& categoryValues,
-        SmoothingType smoothing = SmoothingType::None,
-        int smoothingParam = 5,
-        NormalizationType normalization = NormalizationType::None);
     //QVariant prepareDataSample();
 public:
     void fromVariantMap(const QVariantMap& variantMap) override;
@@ -110,11 +144,22 @@ private:
     QTimer _dimensionYRangeDebounceTimer;
     QTimer _smoothingTypeDebounceTimer;
     QTimer _normalizationTypeDebounceTimer;
+    QTimer _statLineTypeDebounceTimer;
+    QTimer _changePointDebounceTimer;
+    QTimer _xAggregationDebounceTimer;
     QTimer _smoothingWindowDebounceTimer;
     QTimer  _colorDatasetDebounceTimer;
     QTimer  _colorPointDatasetDimensionDebounceTimer;
     QTimer  _colorPointDatasetColorMapDebounceTimer;
     QTimer  _colorMapRangeDebounceTimer;
+    std::shared_ptr<LinePlotPipeline> _pipeline;        // Memoizing data pipeline, shared with the worker running it
+    quint64                 _pointDatasetRevision = 0;  // Bumped whenever the point dataset reports changed data
+    std::shared_ptr<const LinePlotSource> _source;      // Columns the pipeline reads, copied from the datasets on the GUI thread
+    std::shared_ptr<const LinePlotOverlaySource> _overlaySource;    // Overlay columns, copied the same way
+    QThreadPool             _pipelineThreadPool;        // Worker pool the data pipeline runs on
+    CancellationToken       _pipelineCancellation;      // Cancels the pipeline run currently in flight
+    quint64                 _pipelineGeneration = 0;    // Generation of the latest request, older results are discarded
+    int                     _plotWidth = 0;             // Plot width in device pixels, the cubic spline is sampled this densely
 };
 
 /**
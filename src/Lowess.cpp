@@ -0,0 +1,148 @@
+#include "Lowess.h"
+
+#include "ParallelUtils.h"
+#include "RadixSort.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    /**
+     * Fits the local line at each of the ascending positions xs[begin, end) and writes its value to out.
+     * \p x and \p y are sorted by X, \p robustness holds per point weights or is empty.
+     */
+    void fitRange(const float* x, const float* y, std::size_t n, std::size_t neighbors, const std::vector<float>& robustness,
+        const double* xs, std::size_t begin, std::size_t end, double* out)
+    {
+        // Window [left, left + neighbors) of nearest points, starting no later than the first optimum
+        const auto position = static_cast<std::size_t>(std::lower_bound(x, x + n, static_cast<float>(xs[begin])) - x);
+        std::size_t left = std::min(position > neighbors ? position - neighbors : 0, n - neighbors);
+
+        for (std::size_t e = begin; e < end; ++e) {
+            const double xe = xs[e];
+            while (left + neighbors < n && static_cast<double>(x[left + neighbors]) - xe < xe - static_cast<double>(x[left]))
+                ++left;
+
+            const std::size_t right = left + neighbors;
+            const double radius = std::max(xe - static_cast<double>(x[left]), static_cast<double>(x[right - 1]) - xe);
+            const double scale = radius > 0.0 ? 1.0 / (radius * (1.0 + 1e-9)) : 0.0;
+
+            // Weighted sums around xe, the local line is evaluated at its center
+            double s0 = 0.0, s1 = 0.0, s2 = 0.0, t0 = 0.0, t1 = 0.0;
+            for (std::size_t j = left; j < right; ++j) {
+                const double dx = static_cast<double>(x[j]) - xe;
+                const double u = std::abs(dx) * scale;
+                if (u >= 1.0)
+                    continue;
+                const double c = 1.0 - u * u * u;
+                double w = c * c * c;
+                if (!robustness.empty())
+                    w *= robustness[j];
+                s0 += w;
+                s1 += w * dx;
+                s2 += w * dx * dx;
+                t0 += w * y[j];
+                t1 += w * dx * y[j];
+            }
+
+            if (s0 <= 0.0) {
+                // Every neighbor was rejected, fall back to the nearest point
+                const std::size_t nearest = xe - static_cast<double>(x[left]) <= static_cast<double>(x[right - 1]) - xe ? left : right - 1;
+                out[e] = y[nearest];
+                continue;
+            }
+
+            const double determinant = s0 * s2 - s1 * s1;
+            out[e] = determinant > 1e-12 * s0 * s2 ? (s2 * t0 - s1 * t1) / determinant : t0 / s0;
+        }
+    }
+
+    // Linear interpolation of the curve (xs, values) at the ascending positions x
+    void interpolate(const double* xs, const double* values, std::size_t count, const float* x, std::size_t n, double* out)
+    {
+        std::size_t segment = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            const double xi = x[i];
+            while (segment + 2 < count && xs[segment + 1] <= xi)
+                ++segment;
+            const double width = xs[segment + 1] - xs[segment];
+            const double t = width > 0.0 ? std::clamp((xi - xs[segment]) / width, 0.0, 1.0) : 0.0;
+            out[i] = values[segment] + t * (values[segment + 1] - values[segment]);
+        }
+    }
+}
+
+void applyLowess(const LineSeries& data, float span, int robustnessIterations, std::size_t gridSize, LineSeries& smoothed, SmoothingWorkspace* workspace)
+{
+    SmoothingWorkspace localWorkspace;
+    LineSeries& sorted = (workspace ? *workspace : localWorkspace).sorted;
+    const LineSeries& input = sortSeriesByX(data, sorted) ? sorted : data;
+    const std::size_t n = input.size();
+    if (n < 3) {
+        smoothed = input;
+        return;
+    }
+
+    const float* x = input.xData();
+    const float* y = input.yData();
+    // Rounded down in double with a small tolerance as in Cleveland's lowess, so float spans like 0.3 hit exact counts
+    const double fraction = std::clamp(static_cast<double>(span), 0.0, 1.0);
+    const std::size_t neighbors = std::clamp<std::size_t>(static_cast<std::size_t>(std::floor(fraction * static_cast<double>(n) + 1e-5)), 2, n);
+    const bool onGrid = gridSize >= 2 && gridSize < n;
+
+    // Evaluation positions: the data X, or an even grid over its range
+    std::vector<double> xs(onGrid ? gridSize : n);
+    if (onGrid) {
+        const double step = (static_cast<double>(x[n - 1]) - x[0]) / static_cast<double>(gridSize - 1);
+        for (std::size_t i = 0; i < gridSize; ++i)
+            xs[i] = x[0] + step * static_cast<double>(i);
+        xs.back() = x[n - 1];
+    }
+    else {
+        std::copy_n(x, n, xs.begin());
+    }
+
+    std::vector<double> fitted(xs.size()), pointFit(onGrid ? n : 0), residuals(n);
+    std::vector<float> robustness;
+    const std::size_t evaluations = xs.size();
+    const std::size_t numChunks = parallelChunkCount(evaluations, std::max<std::size_t>(1, (1 << 18) / neighbors));
+
+    for (int iteration = 0; iteration <= std::max(robustnessIterations, 0); ++iteration) {
+        parallelForChunks(evaluations, numChunks, [&](std::size_t, std::size_t begin, std::size_t end) {
+            fitRange(x, y, n, neighbors, robustness, xs.data(), begin, end, fitted.data());
+            });
+
+        if (iteration == robustnessIterations)
+            break;
+
+        // Bisquare weights from the residuals at the data points
+        const double* fit = fitted.data();
+        if (onGrid) {
+            interpolate(xs.data(), fitted.data(), evaluations, x, n, pointFit.data());
+            fit = pointFit.data();
+        }
+        for (std::size_t i = 0; i < n; ++i)
+            residuals[i] = std::abs(y[i] - fit[i]);
+
+        std::vector<double> magnitudes(residuals);
+        std::nth_element(magnitudes.begin(), magnitudes.begin() + n / 2, magnitudes.end());
+        const double medianResidual = magnitudes[n / 2];
+        if (medianResidual <= 0.0)
+            break;
+
+        robustness.resize(n);
+        const double limit = 6.0 * medianResidual;
+        for (std::size_t i = 0; i < n; ++i) {
+            const double u = residuals[i] / limit;
+            robustness[i] = u < 1.0 ? static_cast<float>((1.0 - u * u) * (1.0 - u * u)) : 0.0f;
+        }
+    }
+
+    smoothed.resize(evaluations);
+    for (std::size_t i = 0; i < evaluations; ++i) {
+        smoothed.xData()[i] = static_cast<float>(xs[i]);
+        smoothed.yData()[i] = static_cast<float>(fitted[i]);
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "SmoothingWorkspace.h"
+#include "../libs/LineChartLib/LineSeries.h"
+
+#include <cstddef>
+
+/**
+ * LOWESS (locally weighted scatterplot smoothing) after Cleveland
+ *
+ * The curve at an evaluation point is a weighted least-squares line through its
+ * floor(span * n) nearest neighbors in X, weighted by the tricube of their distance
+ * relative to the farthest neighbor. Each robustness iteration refits with the
+ * weights multiplied by the bisquare of the residuals over six times their
+ * median absolute value, which suppresses outliers.
+ *
+ * The data is traversed in X order; the neighborhoods of ascending evaluation
+ * points form a window that only slides forward, so no evaluation point scans
+ * the full series. Evaluation points are split over the global thread pool.
+ *
+ * With a grid the curve is fitted at \p gridSize evenly spaced X positions only;
+ * residuals for the robustness weights are then taken from the linear
+ * interpolation of the grid, which brings the cost from O(n * k) down to
+ * O(gridSize * k + n).
+ *
+ * @param data Points to smooth, in any X order
+ * @param span Fraction of the points in each neighborhood, in (0, 1]
+ * @param robustnessIterations Number of robustness refits
+ * @param gridSize Number of evaluation points, 0 (or at least the point count) evaluates at every point
+ * @param smoothed Receives the curve at the data X, or at the grid
+ * @param workspace Keeps the X-sorted copy of \p data between calls, optional
+ */
+void applyLowess(const LineSeries& data, float span, int robustnessIterations, std::size_t gridSize, LineSeries& smoothed, SmoothingWorkspace* workspace = nullptr);
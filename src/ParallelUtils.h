@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QtConcurrent>
+#include <QThread>
+#include <QVector>
+
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+
+// Number of chunks to split count items into so that every chunk holds at least minChunkSize items
+inline std::size_t parallelChunkCount(std::size_t count, std::size_t minChunkSize)
+{
+    const auto threads = static_cast<std::size_t>(std::max(1, QThread::idealThreadCount()));
+    return std::clamp<std::size_t>(count / std::max<std::size_t>(minChunkSize, 1), 1, threads);
+}
+
+// First item of chunk in [0, count) split into numChunks contiguous chunks
+inline std::size_t parallelChunkBegin(std::size_t count, std::size_t numChunks, std::size_t chunk)
+{
+    return count / numChunks * chunk + std::min(chunk, count % numChunks);
+}
+
+// Runs body(chunk, begin, end) for every contiguous chunk of [0, count) on the global thread pool.
+// Chunk boundaries only depend on count and numChunks, so consecutive calls see the same split.
+template <typename Body>
+void parallelForChunks(std::size_t count, std::size_t numChunks, Body&& body)
+{
+    numChunks = std::max<std::size_t>(numChunks, 1);
+    if (numChunks == 1) {
+        body(std::size_t(0), std::size_t(0), count);
+        return;
+    }
+
+    QVector<std::size_t> chunks(static_cast<int>(numChunks));
+    std::iota(chunks.begin(), chunks.end(), std::size_t(0));
+    QtConcurrent::blockingMap(chunks, [&body, count, numChunks](const std::size_t& chunk) {
+        body(chunk, parallelChunkBegin(count, numChunks, chunk), parallelChunkBegin(count, numChunks, chunk + 1));
+        });
+}
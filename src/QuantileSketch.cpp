@@ -0,0 +1,149 @@
+#include "QuantileSketch.h"
+
+#include "ParallelUtils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+QuantileSketch::QuantileSketch(std::size_t k) :
+    _k(std::max<std::size_t>(k, 8))
+{
+    addLevel();
+}
+
+std::size_t QuantileSketch::capacity(std::size_t level) const
+{
+    // Top level holds k items, every level below two thirds of the one above
+    const std::size_t depth = _levels.size() - 1 - level;
+    return std::max<std::size_t>(2, static_cast<std::size_t>(std::ceil(static_cast<double>(_k) * std::pow(2.0 / 3.0, static_cast<double>(depth)))));
+}
+
+void QuantileSketch::addLevel()
+{
+    _levels.emplace_back();
+    _maxSize = 0;
+    for (std::size_t level = 0; level < _levels.size(); ++level)
+        _maxSize += capacity(level);
+}
+
+void QuantileSketch::compress()
+{
+    for (std::size_t level = 0; level < _levels.size(); ++level) {
+        if (_levels[level].size() < capacity(level))
+            continue;
+
+        if (level + 1 == _levels.size())
+            addLevel();
+
+        auto& items = _levels[level];
+        auto& above = _levels[level + 1];
+        std::sort(items.begin(), items.end());
+
+        // An odd item out stays behind, so the total weight is preserved exactly
+        const std::size_t paired = items.size() & ~std::size_t(1);
+        _random ^= _random << 13;
+        _random ^= _random >> 7;
+        _random ^= _random << 17;
+        for (std::size_t i = _random & 1; i < paired; i += 2)
+            above.push_back(items[i]);
+
+        const bool leftover = paired < items.size();
+        const float last = items.back();
+        items.clear();
+        if (leftover)
+            items.push_back(last);
+
+        _size -= paired / 2;
+        return;
+    }
+}
+
+void QuantileSketch::insert(float value)
+{
+    _levels[0].push_back(value);
+    ++_count;
+    ++_size;
+    if (_size >= _maxSize)
+        compress();
+}
+
+void QuantileSketch::insert(const float* values, std::size_t count)
+{
+    // Fill the free room in one go, compacting only when the sketch is full
+    while (count > 0) {
+        const std::size_t batch = std::min(count, std::max<std::size_t>(_maxSize - std::min(_size, _maxSize), 1));
+        _levels[0].insert(_levels[0].end(), values, values + batch);
+        _count += batch;
+        _size += batch;
+        values += batch;
+        count -= batch;
+        if (_size >= _maxSize)
+            compress();
+    }
+}
+
+void QuantileSketch::merge(const QuantileSketch& other)
+{
+    while (_levels.size() < other._levels.size())
+        addLevel();
+    for (std::size_t level = 0; level < other._levels.size(); ++level)
+        _levels[level].insert(_levels[level].end(), other._levels[level].begin(), other._levels[level].end());
+
+    _count += other._count;
+    _size += other._size;
+    while (_size >= _maxSize) {
+        const std::size_t size = _size;
+        compress();
+        if (_size == size)
+            break;
+    }
+}
+
+template <typename Transform>
+float QuantileSketch::weightedRank(double q, Transform transform) const
+{
+    if (_count == 0)
+        return 0.0f;
+
+    std::vector<std::pair<float, std::uint64_t>> items;
+    items.reserve(_size);
+    for (std::size_t level = 0; level < _levels.size(); ++level) {
+        for (const float value : _levels[level])
+            items.emplace_back(transform(value), std::uint64_t(1) << level);
+    }
+    std::sort(items.begin(), items.end());
+
+    const double rank = std::floor(std::clamp(q, 0.0, 1.0) * static_cast<double>(_count - 1));
+    std::uint64_t cumulative = 0;
+    for (const auto& [value, weight] : items) {
+        cumulative += weight;
+        if (static_cast<double>(cumulative) > rank)
+            return value;
+    }
+    return items.back().first;
+}
+
+float QuantileSketch::quantile(double q) const
+{
+    return weightedRank(q, [](float value) { return value; });
+}
+
+float QuantileSketch::medianAbsoluteDeviation(float center) const
+{
+    return weightedRank(0.5, [center](float value) { return std::abs(value - center); });
+}
+
+QuantileSketch buildQuantileSketch(const float* values, std::size_t count)
+{
+    const std::size_t numChunks = parallelChunkCount(count, 1 << 18);
+    std::vector<QuantileSketch> sketches(numChunks);
+    parallelForChunks(count, numChunks, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+        sketches[chunk].insert(values + begin, end - begin);
+        });
+
+    QuantileSketch sketch = std::move(sketches[0]);
+    for (std::size_t chunk = 1; chunk < numChunks; ++chunk)
+        sketch.merge(sketches[chunk]);
+    return sketch;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Mergeable streaming quantile sketch after Karnin, Lang and Liberty (KLL)
+ *
+ * Values are kept in a stack of compactors; level h holds items of weight 2^h.
+ * When the sketch is full, the lowest level over its capacity is sorted and every
+ * other item, starting at a random offset, is promoted to the level above. Level
+ * capacities shrink geometrically towards the bottom, so the sketch stays at
+ * O(k) items whatever the input size, with a rank error of roughly 1.7 / k.
+ *
+ * Sketches of disjoint parts of the data merge into a sketch of the whole, which
+ * lets large columns be summarized block-wise on several threads. The random
+ * offsets come from a fixed seed, so the same input gives the same sketch.
+ */
+class QuantileSketch
+{
+public:
+    explicit QuantileSketch(std::size_t k = 1024);
+
+    void insert(float value);
+    void insert(const float* values, std::size_t count);
+
+    /** Absorb \p other, a sketch of different values */
+    void merge(const QuantileSketch& other);
+
+    /** Number of values inserted, including those of merged sketches */
+    std::size_t count() const { return _count; }
+    bool isEmpty() const { return _count == 0; }
+
+    /** Approximate value of rank floor(q * (count - 1)), like RollingQuantile */
+    float quantile(double q) const;
+
+    /** Approximate median of |value - center| */
+    float medianAbsoluteDeviation(float center) const;
+
+private:
+    std::size_t capacity(std::size_t level) const;
+    void addLevel();
+    void compress();
+
+    /** Value of rank q among the retained items mapped by \p transform, each counted with its weight */
+    template <typename Transform>
+    float weightedRank(double q, Transform transform) const;
+
+    std::size_t                     _k;
+    std::size_t                     _count = 0;
+    std::size_t                     _size = 0;      // Retained items over all levels
+    std::size_t                     _maxSize = 0;   // Sum of the level capacities
+    std::vector<std::vector<float>> _levels;
+    std::uint64_t                   _random = 0x9e3779b97f4a7c15ull;
+};
+
+/** Sketch of \p count values, built block-wise on the global thread pool */
+QuantileSketch buildQuantileSketch(const float* values, std::size_t count);
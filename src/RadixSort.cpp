@@ -0,0 +1,100 @@
+#include "RadixSort.h"
+
+#include <algorithm>
+#include <array>
+
+namespace
+{
+    constexpr int           kRadixBits  = 8;
+    constexpr std::size_t   kBuckets    = std::size_t(1) << kRadixBits;
+    constexpr int           kPasses     = 32 / kRadixBits;
+}
+
+void radixSortPermutation(const float* values, std::size_t count, SortPermutation& permutation)
+{
+    permutation.resize(count);
+    if (count == 0)
+        return;
+
+    const std::size_t numChunks = parallelChunkCount(count, 1 << 16);
+
+    std::vector<std::uint32_t> keys(count), keysBuffer(count);
+    SortPermutation indicesBuffer(count);
+
+    parallelForChunks(count, numChunks, [&](std::size_t, std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            keys[i] = floatToOrderedKey(values[i]);
+            permutation[i] = static_cast<std::uint32_t>(i);
+        }
+        });
+
+    std::uint32_t* sourceKeys = keys.data();
+    std::uint32_t* targetKeys = keysBuffer.data();
+    std::uint32_t* sourceIndices = permutation.data();
+    std::uint32_t* targetIndices = indicesBuffer.data();
+
+    // Histogram per chunk, laid out chunk-major
+    std::vector<std::size_t> offsets(numChunks * kBuckets);
+
+    for (int pass = 0; pass < kPasses; ++pass) {
+        const int shift = pass * kRadixBits;
+
+        parallelForChunks(count, numChunks, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+            std::size_t* histogram = offsets.data() + chunk * kBuckets;
+            std::fill(histogram, histogram + kBuckets, std::size_t(0));
+            for (std::size_t i = begin; i < end; ++i)
+                ++histogram[(sourceKeys[i] >> shift) & (kBuckets - 1)];
+            });
+
+        // A pass in which every key has the same digit would not move anything
+        bool trivialPass = false;
+        for (std::size_t bucket = 0; bucket < kBuckets && !trivialPass; ++bucket) {
+            std::size_t bucketTotal = 0;
+            for (std::size_t chunk = 0; chunk < numChunks; ++chunk)
+                bucketTotal += offsets[chunk * kBuckets + bucket];
+            trivialPass = bucketTotal == count;
+        }
+        if (trivialPass)
+            continue;
+
+        // Exclusive prefix sum in bucket-major, chunk-minor order keeps the sort stable
+        std::size_t offset = 0;
+        for (std::size_t bucket = 0; bucket < kBuckets; ++bucket) {
+            for (std::size_t chunk = 0; chunk < numChunks; ++chunk) {
+                const std::size_t bucketCount = offsets[chunk * kBuckets + bucket];
+                offsets[chunk * kBuckets + bucket] = offset;
+                offset += bucketCount;
+            }
+        }
+
+        parallelForChunks(count, numChunks, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+            std::array<std::size_t, kBuckets> positions;
+            std::copy_n(offsets.data() + chunk * kBuckets, kBuckets, positions.begin());
+            for (std::size_t i = begin; i < end; ++i) {
+                const std::size_t position = positions[(sourceKeys[i] >> shift) & (kBuckets - 1)]++;
+                targetKeys[position] = sourceKeys[i];
+                targetIndices[position] = sourceIndices[i];
+            }
+            });
+
+        std::swap(sourceKeys, targetKeys);
+        std::swap(sourceIndices, targetIndices);
+    }
+
+    if (sourceIndices != permutation.data())
+        permutation.swap(indicesBuffer);
+}
+
+bool sortSeriesByX(const LineSeries& series, LineSeries& sorted)
+{
+    const std::size_t n = series.size();
+    if (std::is_sorted(series.xData(), series.xData() + n))
+        return false;
+
+    SortPermutation permutation;
+    radixSortPermutation(series.xData(), n, permutation);
+    sorted.resize(n);
+    gatherByPermutation(series.xData(), permutation, sorted.xData());
+    gatherByPermutation(series.yData(), permutation, sorted.yData());
+    return true;
+}
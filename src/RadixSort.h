@@ -0,0 +1,45 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../libs/LineChartLib/LineSeries.h"
+#include "ParallelUtils.h"
+
+using SortPermutation = std::vector<std::uint32_t>;
+
+// Maps a float onto an unsigned key with the same ordering (negative values first, NaNs at the ends)
+inline std::uint32_t floatToOrderedKey(float value)
+{
+    const auto bits = std::bit_cast<std::uint32_t>(value);
+    return bits ^ ((bits & 0x80000000u) ? 0xFFFFFFFFu : 0x80000000u);
+}
+
+/**
+ * Stable, parallel LSD radix sort of \p values
+ *
+ * Sorts order-preserving 32-bit keys in four 8-bit passes; passes in which all
+ * keys share the same digit are skipped. Each pass builds per-chunk histograms
+ * and scatters the chunks concurrently into their precomputed output ranges.
+ *
+ * @param values Values to sort, left untouched
+ * @param count Number of values
+ * @param permutation Receives the indices of \p values in ascending order
+ */
+void radixSortPermutation(const float* values, std::size_t count, SortPermutation& permutation);
+
+// Writes target[i] = source[permutation[i]] for all i, in parallel
+template <typename T>
+void gatherByPermutation(const T* source, const SortPermutation& permutation, T* target)
+{
+    const std::size_t count = permutation.size();
+    parallelForChunks(count, parallelChunkCount(count, 1 << 16), [&](std::size_t, std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i)
+            target[i] = source[permutation[i]];
+        });
+}
+
+// Copies series into sorted in ascending X order; returns false and leaves sorted alone when series is sorted already
+bool sortSeriesByX(const LineSeries& series, LineSeries& sorted);
@@ -0,0 +1,147 @@
+#include "RollingQuantile.h"
+
+#include <algorithm>
+#include <cmath>
+
+RollingQuantile::RollingQuantile(double quantile) :
+    _quantile(std::clamp(quantile, 0.0, 1.0))
+{
+}
+
+void RollingQuantile::setQuantile(double quantile)
+{
+    _quantile = std::clamp(quantile, 0.0, 1.0);
+    rebalance();
+}
+
+void RollingQuantile::reserve(std::size_t capacity)
+{
+    _nodes.reserve(capacity);
+    _free.reserve(capacity);
+    _lower.reserve(capacity);
+    _upper.reserve(capacity);
+}
+
+void RollingQuantile::clear()
+{
+    _nodes.clear();
+    _free.clear();
+    _lower.clear();
+    _upper.clear();
+}
+
+bool RollingQuantile::before(bool lower, Handle a, Handle b) const
+{
+    return lower ? _nodes[a].value > _nodes[b].value : _nodes[a].value < _nodes[b].value;
+}
+
+void RollingQuantile::place(std::vector<Handle>& heap, std::uint32_t position, Handle handle)
+{
+    heap[position] = handle;
+    _nodes[handle].position = position;
+}
+
+void RollingQuantile::siftUp(bool lower, std::uint32_t position)
+{
+    auto& heap = lower ? _lower : _upper;
+    const Handle handle = heap[position];
+    while (position > 0) {
+        const std::uint32_t parent = (position - 1) / 2;
+        if (!before(lower, handle, heap[parent]))
+            break;
+        place(heap, position, heap[parent]);
+        position = parent;
+    }
+    place(heap, position, handle);
+}
+
+void RollingQuantile::siftDown(bool lower, std::uint32_t position)
+{
+    auto& heap = lower ? _lower : _upper;
+    const auto count = static_cast<std::uint32_t>(heap.size());
+    const Handle handle = heap[position];
+    while (true) {
+        std::uint32_t child = 2 * position + 1;
+        if (child >= count)
+            break;
+        if (child + 1 < count && before(lower, heap[child + 1], heap[child]))
+            ++child;
+        if (!before(lower, heap[child], handle))
+            break;
+        place(heap, position, heap[child]);
+        position = child;
+    }
+    place(heap, position, handle);
+}
+
+void RollingQuantile::push(bool lower, Handle handle)
+{
+    auto& heap = lower ? _lower : _upper;
+    _nodes[handle].lower = lower;
+    heap.push_back(handle);
+    siftUp(lower, static_cast<std::uint32_t>(heap.size() - 1));
+}
+
+RollingQuantile::Handle RollingQuantile::pop(bool lower)
+{
+    const Handle top = (lower ? _lower : _upper).front();
+    removeAt(lower, 0);
+    return top;
+}
+
+void RollingQuantile::removeAt(bool lower, std::uint32_t position)
+{
+    auto& heap = lower ? _lower : _upper;
+    const Handle last = heap.back();
+    heap.pop_back();
+    if (position == heap.size())
+        return;
+
+    // The former last element takes the freed place and moves whichever way restores the heap
+    place(heap, position, last);
+    siftUp(lower, position);
+    siftDown(lower, _nodes[last].position);
+}
+
+std::size_t RollingQuantile::lowerTarget() const
+{
+    const std::size_t count = size();
+    if (count == 0)
+        return 0;
+    return static_cast<std::size_t>(std::floor(_quantile * static_cast<double>(count - 1))) + 1;
+}
+
+void RollingQuantile::rebalance()
+{
+    const std::size_t target = lowerTarget();
+    while (_lower.size() > target)
+        push(false, pop(true));
+    while (_lower.size() < target)
+        push(true, pop(false));
+}
+
+RollingQuantile::Handle RollingQuantile::insert(float value)
+{
+    Handle handle;
+    if (_free.empty()) {
+        handle = static_cast<Handle>(_nodes.size());
+        _nodes.emplace_back();
+    }
+    else {
+        handle = _free.back();
+        _free.pop_back();
+    }
+    _nodes[handle].value = value;
+
+    push(!_lower.empty() && value <= _nodes[_lower.front()].value, handle);
+    rebalance();
+    return handle;
+}
+
+void RollingQuantile::erase(Handle handle)
+{
+    const Node& node = _nodes[handle];
+    removeAt(node.lower, node.position);
+    _free.push_back(handle);
+    rebalance();
+}
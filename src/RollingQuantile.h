@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Quantile of a changing multiset of values
+ *
+ * Values are split over two indexable binary heaps: a max-heap with the values up
+ * to the quantile rank and a min-heap with the rest. Every value is addressed by a
+ * handle, so any value can be removed in O(log n), not only the oldest one; windows
+ * can therefore grow and shrink freely. Nodes live in a pool that is reused after
+ * removal, so a sliding window does not allocate once the pool has grown to the
+ * window size.
+ *
+ * The quantile q of n values is the value of rank floor(q * (n - 1)) in ascending
+ * order; for q = 0.5 and odd n that is the median.
+ */
+class RollingQuantile
+{
+public:
+    using Handle = std::uint32_t;
+
+    explicit RollingQuantile(double quantile = 0.5);
+
+    /** Set the quantile in [0, 1] */
+    void setQuantile(double quantile);
+    double getQuantile() const { return _quantile; }
+
+    /** Reserve room for \p capacity values */
+    void reserve(std::size_t capacity);
+
+    /** Remove all values, keeping the pool */
+    void clear();
+
+    std::size_t size() const { return _lower.size() + _upper.size(); }
+    bool isEmpty() const { return size() == 0; }
+
+    /** Add \p value, the handle stays valid until the value is erased */
+    Handle insert(float value);
+
+    /** Remove the value added under \p handle */
+    void erase(Handle handle);
+
+    /** Quantile of the current values, which must not be empty */
+    float value() const { return _nodes[_lower.front()].value; }
+
+private:
+    struct Node {
+        float           value = 0.0f;
+        std::uint32_t   position = 0;   // Index in its heap
+        bool            lower = false;  // In the max-heap of lower values
+    };
+
+    std::vector<Handle>& heapOf(const Node& node) { return node.lower ? _lower : _upper; }
+
+    /** True when \p a must sit above \p b in the heap of lower (max-heap) or upper (min-heap) values */
+    bool before(bool lower, Handle a, Handle b) const;
+
+    void place(std::vector<Handle>& heap, std::uint32_t position, Handle handle);
+    void siftUp(bool lower, std::uint32_t position);
+    void siftDown(bool lower, std::uint32_t position);
+    void push(bool lower, Handle handle);
+    Handle pop(bool lower);
+    void removeAt(bool lower, std::uint32_t position);
+
+    /** Number of values the lower heap must hold for the current size */
+    std::size_t lowerTarget() const;
+
+    /** Move heap tops until the lower heap holds exactly the values up to the quantile rank */
+    void rebalance();
+
+private:
+    double                  _quantile;
+    std::vector<Node>       _nodes;     // Node pool, indexed by handle
+    std::vector<Handle>     _free;      // Handles of removed values, reused first
+    std::vector<Handle>     _lower;     // Max-heap
+    std::vector<Handle>     _upper;     // Min-heap
+};
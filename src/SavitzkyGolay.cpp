@@ -0,0 +1,140 @@
+#include "SavitzkyGolay.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <cmath>
+#include <map>
+#include <tuple>
+
+namespace
+{
+    // Falling factorial k * (k - 1) * ... * (k - d + 1), the factor of u^(k - d) in the d-th derivative of u^k
+    double fallingFactorial(int k, int d)
+    {
+        double result = 1.0;
+        for (int i = 0; i < d; ++i)
+            result *= k - i;
+        return result;
+    }
+
+    // Solves the symmetric positive definite system A X = B in place with Gaussian elimination and partial pivoting,
+    // A is size x size, B is size x columns, both row-major
+    void solve(std::vector<double>& a, std::vector<double>& b, int size, int columns)
+    {
+        for (int pivot = 0; pivot < size; ++pivot) {
+            int best = pivot;
+            for (int row = pivot + 1; row < size; ++row) {
+                if (std::abs(a[row * size + pivot]) > std::abs(a[best * size + pivot]))
+                    best = row;
+            }
+            if (best != pivot) {
+                for (int column = 0; column < size; ++column)
+                    std::swap(a[pivot * size + column], a[best * size + column]);
+                for (int column = 0; column < columns; ++column)
+                    std::swap(b[pivot * columns + column], b[best * columns + column]);
+            }
+
+            const double diagonal = a[pivot * size + pivot];
+            for (int row = 0; row < size; ++row) {
+                if (row == pivot)
+                    continue;
+                const double factor = a[row * size + pivot] / diagonal;
+                if (factor == 0.0)
+                    continue;
+                for (int column = pivot; column < size; ++column)
+                    a[row * size + column] -= factor * a[pivot * size + column];
+                for (int column = 0; column < columns; ++column)
+                    b[row * columns + column] -= factor * b[pivot * columns + column];
+            }
+        }
+
+        for (int row = 0; row < size; ++row) {
+            const double diagonal = a[row * size + row];
+            for (int column = 0; column < columns; ++column)
+                b[row * columns + column] /= diagonal;
+        }
+    }
+
+    std::shared_ptr<const SavitzkyGolayKernel> computeKernel(int windowSize, int polynomialOrder, int derivativeOrder)
+    {
+        auto kernel = std::make_shared<SavitzkyGolayKernel>();
+        kernel->windowSize = windowSize;
+        kernel->polynomialOrder = polynomialOrder;
+        kernel->derivativeOrder = derivativeOrder;
+
+        const int half = windowSize / 2;
+        const int terms = polynomialOrder + 1;
+        const double scale = half > 0 ? 1.0 / half : 1.0;
+
+        // Vandermonde matrix V (window x terms) of the scaled positions
+        std::vector<double> vandermonde(static_cast<std::size_t>(windowSize) * terms);
+        for (int j = 0; j < windowSize; ++j) {
+            const double u = (j - half) * scale;
+            double power = 1.0;
+            for (int k = 0; k < terms; ++k) {
+                vandermonde[j * terms + k] = power;
+                power *= u;
+            }
+        }
+
+        // Normal equations: projection = (V^T V)^-1 V^T
+        std::vector<double> normal(static_cast<std::size_t>(terms) * terms, 0.0);
+        for (int j = 0; j < windowSize; ++j) {
+            for (int k = 0; k < terms; ++k) {
+                for (int l = 0; l < terms; ++l)
+                    normal[k * terms + l] += vandermonde[j * terms + k] * vandermonde[j * terms + l];
+            }
+        }
+
+        kernel->projection.resize(static_cast<std::size_t>(terms) * windowSize);
+        for (int k = 0; k < terms; ++k) {
+            for (int j = 0; j < windowSize; ++j)
+                kernel->projection[k * windowSize + j] = vandermonde[j * terms + k];
+        }
+        solve(normal, kernel->projection, terms, windowSize);
+
+        // At the center only the coefficient of u^d survives differentiation
+        kernel->center.assign(windowSize, 0.0f);
+        if (derivativeOrder <= polynomialOrder) {
+            const double factor = fallingFactorial(derivativeOrder, derivativeOrder) * std::pow(scale, derivativeOrder);
+            for (int j = 0; j < windowSize; ++j)
+                kernel->center[j] = static_cast<float>(factor * kernel->projection[derivativeOrder * windowSize + j]);
+        }
+
+        return kernel;
+    }
+}
+
+double SavitzkyGolayKernel::evaluate(const double* coefficients, int offset) const
+{
+    const double scale = half() > 0 ? 1.0 / half() : 1.0;
+    const double u = offset * scale;
+
+    double value = 0.0;
+    double power = 1.0;
+    for (int k = derivativeOrder; k <= polynomialOrder; ++k) {
+        value += coefficients[k] * fallingFactorial(k, derivativeOrder) * power;
+        power *= u;
+    }
+    return value * std::pow(scale, derivativeOrder);
+}
+
+std::shared_ptr<const SavitzkyGolayKernel> savitzkyGolayKernel(int windowSize, int polynomialOrder, int derivativeOrder)
+{
+    static QMutex mutex;
+    static std::map<std::tuple<int, int, int>, std::shared_ptr<const SavitzkyGolayKernel>> cache;
+
+    QMutexLocker locker(&mutex);
+
+    // Dragging the window slider visits many sizes, keep the cache bounded
+    constexpr std::size_t kMaximumCachedKernels = 32;
+    const std::tuple<int, int, int> key{ windowSize, polynomialOrder, derivativeOrder };
+    if (cache.size() >= kMaximumCachedKernels && cache.find(key) == cache.end())
+        cache.clear();
+
+    auto& kernel = cache[key];
+    if (!kernel)
+        kernel = computeKernel(windowSize, polynomialOrder, derivativeOrder);
+    return kernel;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+/**
+ * Savitzky-Golay filter coefficients for one window size, polynomial order and derivative order
+ *
+ * A polynomial of the given order is least-squares fitted to every window of
+ * samples. For full windows the smoothed value (or derivative) at the window
+ * center is a fixed linear combination of the samples, stored in center. Near
+ * the ends the fit of the first or last full window is evaluated off-center,
+ * using the projection onto the polynomial coefficients.
+ *
+ * Positions are scaled to u = j / half in [-1, 1] to keep the fit well conditioned.
+ * Derivatives are per sample; callers scale them to their X units.
+ */
+struct SavitzkyGolayKernel
+{
+    int                 windowSize = 0;         // Odd number of samples per window
+    int                 polynomialOrder = 0;    // Smaller than windowSize
+    int                 derivativeOrder = 0;
+    std::vector<float>  center;                 // Weights of the window samples for the window center
+    std::vector<double> projection;             // (polynomialOrder + 1) x windowSize, maps samples to polynomial coefficients in u
+
+    int half() const { return windowSize / 2; }
+
+    /** Value (or derivative) of the polynomial with \p coefficients at offset \p offset from the window center */
+    double evaluate(const double* coefficients, int offset) const;
+};
+
+/**
+ * Coefficients for (\p windowSize, \p polynomialOrder, \p derivativeOrder), computed once and cached
+ * @param windowSize Odd window size
+ * @param polynomialOrder Polynomial order, smaller than \p windowSize
+ * @param derivativeOrder Derivative order, zero for smoothing
+ */
+std::shared_ptr<const SavitzkyGolayKernel> savitzkyGolayKernel(int windowSize, int polynomialOrder, int derivativeOrder);
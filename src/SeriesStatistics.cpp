@@ -0,0 +1,286 @@
+#include "SeriesStatistics.h"
+
+#include "ParallelUtils.h"
+#include "QuantileSketch.h"
+
+#include <cmath>
+#include <iterator>
+#include <vector>
+
+namespace
+{
+    // Values per block, small enough for the second loop to hit L1
+    constexpr std::size_t kBlockSize = 4096;
+
+    // Independent accumulators per lane, so the loops vectorize without reassociating floating point math
+    constexpr std::size_t kLanes = 8;
+
+    ColumnStatistics blockStatistics(const float* values, std::size_t count)
+    {
+        ColumnStatistics statistics;
+        if (count == 0)
+            return statistics;
+
+        const std::size_t vectorCount = count - count % kLanes;
+        double sum[kLanes] = {};
+        float min[kLanes], max[kLanes];
+        std::fill(std::begin(min), std::end(min), values[0]);
+        std::fill(std::begin(max), std::end(max), values[0]);
+        for (std::size_t i = 0; i < vectorCount; i += kLanes) {
+            for (std::size_t lane = 0; lane < kLanes; ++lane) {
+                const float value = values[i + lane];
+                sum[lane] += value;
+                min[lane] = value < min[lane] ? value : min[lane];
+                max[lane] = value > max[lane] ? value : max[lane];
+            }
+        }
+        for (std::size_t i = vectorCount; i < count; ++i) {
+            sum[0] += values[i];
+            min[0] = std::min(min[0], values[i]);
+            max[0] = std::max(max[0], values[i]);
+        }
+
+        double total = 0.0;
+        for (std::size_t lane = 0; lane < kLanes; ++lane) {
+            total += sum[lane];
+            statistics.min = std::min(statistics.min, min[lane]);
+            statistics.max = std::max(statistics.max, max[lane]);
+        }
+
+        const double mean = total / static_cast<double>(count);
+        double m2[kLanes] = {};
+        for (std::size_t i = 0; i < vectorCount; i += kLanes) {
+            for (std::size_t lane = 0; lane < kLanes; ++lane) {
+                const double deviation = values[i + lane] - mean;
+                m2[lane] += deviation * deviation;
+            }
+        }
+        for (std::size_t i = vectorCount; i < count; ++i) {
+            const double deviation = values[i] - mean;
+            m2[0] += deviation * deviation;
+        }
+
+        statistics.count = count;
+        statistics.mean = mean;
+        for (std::size_t lane = 0; lane < kLanes; ++lane)
+            statistics.m2 += m2[lane];
+        return statistics;
+    }
+}
+
+void ColumnStatistics::merge(const ColumnStatistics& other)
+{
+    if (other.count == 0)
+        return;
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+
+    const double total = static_cast<double>(count + other.count);
+    const double delta = other.mean - mean;
+    mean += delta * static_cast<double>(other.count) / total;
+    m2 += other.m2 + delta * delta * static_cast<double>(count) * static_cast<double>(other.count) / total;
+    count += other.count;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+}
+
+void ColumnStatistics::transform(float offset, float scale)
+{
+    if (count == 0)
+        return;
+
+    // Same float operations as the per point transform, so the range stays exact
+    mean = (mean - offset) * scale;
+    m2 *= static_cast<double>(scale) * static_cast<double>(scale);
+    min = (min - offset) * scale;
+    max = (max - offset) * scale;
+}
+
+void SeriesStatistics::transform(float xOffset, float xScale, float yOffset, float yScale)
+{
+    coMoment *= static_cast<double>(xScale) * static_cast<double>(yScale);
+    for (auto* statistics : { &x, &headX, &tailX })
+        statistics->transform(xOffset, xScale);
+    for (auto* statistics : { &y, &headY, &tailY })
+        statistics->transform(yOffset, yScale);
+}
+
+namespace
+{
+    // Statistics of both columns over one range, with their co-moment
+    struct PairStatistics
+    {
+        ColumnStatistics x, y;
+        double coMoment = 0.0;
+
+        void merge(const PairStatistics& other)
+        {
+            if (other.x.count > 0 && x.count > 0) {
+                const double weight = static_cast<double>(x.count) * static_cast<double>(other.x.count) / static_cast<double>(x.count + other.x.count);
+                coMoment += (other.x.mean - x.mean) * (other.y.mean - y.mean) * weight;
+            }
+            coMoment += other.coMoment;
+            x.merge(other.x);
+            y.merge(other.y);
+        }
+    };
+
+    PairStatistics blockPairStatistics(const float* x, const float* y, std::size_t count)
+    {
+        PairStatistics statistics;
+        statistics.x = blockStatistics(x, count);
+        statistics.y = blockStatistics(y, count);
+
+        // Third loop over the block while both columns are still in cache
+        const double meanX = statistics.x.mean, meanY = statistics.y.mean;
+        const std::size_t vectorCount = count - count % kLanes;
+        double coMoment[kLanes] = {};
+        for (std::size_t i = 0; i < vectorCount; i += kLanes) {
+            for (std::size_t lane = 0; lane < kLanes; ++lane)
+                coMoment[lane] += (x[i + lane] - meanX) * (y[i + lane] - meanY);
+        }
+        for (std::size_t i = vectorCount; i < count; ++i)
+            coMoment[0] += (x[i] - meanX) * (y[i] - meanY);
+        for (std::size_t lane = 0; lane < kLanes; ++lane)
+            statistics.coMoment += coMoment[lane];
+        return statistics;
+    }
+
+    PairStatistics computePairStatistics(const float* x, const float* y, std::size_t count)
+    {
+        const std::size_t numBlocks = (count + kBlockSize - 1) / kBlockSize;
+        const std::size_t numChunks = parallelChunkCount(numBlocks, 16);
+
+        // Chunks are merged in order, so the result does not depend on the thread count beyond rounding
+        std::vector<PairStatistics> chunkStatistics(numChunks);
+        parallelForChunks(numBlocks, numChunks, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+            PairStatistics statistics;
+            for (std::size_t block = begin; block < end; ++block) {
+                const std::size_t first = block * kBlockSize;
+                const std::size_t size = std::min(kBlockSize, count - first);
+                statistics.merge(blockPairStatistics(x + first, y + first, size));
+            }
+            chunkStatistics[chunk] = statistics;
+            });
+
+        PairStatistics statistics;
+        for (const auto& partial : chunkStatistics)
+            statistics.merge(partial);
+        return statistics;
+    }
+}
+
+SeriesStatistics computeSeriesStatistics(const LineSeries& data)
+{
+    // Lower and upper half, plus the middle point of an odd series that belongs to both halves
+    const std::size_t n = data.size();
+    const std::size_t lowerEnd = n / 2;
+    const std::size_t upperBegin = n - n / 2;
+    const float* x = data.xData();
+    const float* y = data.yData();
+
+    const PairStatistics lower = computePairStatistics(x, y, lowerEnd);
+    const PairStatistics middle = blockPairStatistics(x + lowerEnd, y + lowerEnd, upperBegin - lowerEnd);
+    const PairStatistics upper = computePairStatistics(x + upperBegin, y + upperBegin, n - upperBegin);
+
+    PairStatistics head = lower;
+    head.merge(middle);
+    PairStatistics tail = middle;
+    tail.merge(upper);
+    PairStatistics all = head;
+    all.merge(upper);
+
+    SeriesStatistics statistics;
+    statistics.x = all.x;
+    statistics.y = all.y;
+    statistics.coMoment = all.coMoment;
+    statistics.headX = head.x;
+    statistics.headY = head.y;
+    statistics.tailX = tail.x;
+    statistics.tailY = tail.y;
+    return statistics;
+}
+
+ColumnStatistics computeColumnStatistics(const float* values, std::size_t count)
+{
+    const std::size_t numBlocks = (count + kBlockSize - 1) / kBlockSize;
+    const std::size_t numChunks = parallelChunkCount(numBlocks, 16);
+
+    std::vector<ColumnStatistics> chunkStatistics(numChunks);
+    parallelForChunks(numBlocks, numChunks, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+        ColumnStatistics statistics;
+        for (std::size_t block = begin; block < end; ++block) {
+            const std::size_t first = block * kBlockSize;
+            statistics.merge(blockStatistics(values + first, std::min(kBlockSize, count - first)));
+        }
+        chunkStatistics[chunk] = statistics;
+        });
+
+    ColumnStatistics statistics;
+    for (const auto& partial : chunkStatistics)
+        statistics.merge(partial);
+    return statistics;
+}
+
+RobustStatistics computeRobustStatistics(const float* values, std::size_t count)
+{
+    RobustStatistics statistics;
+    if (count == 0)
+        return statistics;
+
+    // Ranks as in RollingQuantile: floor(q * (n - 1))
+    const auto rank = [count](double q) { return static_cast<std::size_t>(std::floor(q * static_cast<double>(count - 1))); };
+
+    if (count > kExactSelectionLimit) {
+        const QuantileSketch sketch = buildQuantileSketch(values, count);
+        statistics.median = sketch.quantile(0.5);
+        statistics.mad = sketch.medianAbsoluteDeviation(statistics.median);
+        statistics.lower = sketch.quantile(kClipQuantile);
+        statistics.upper = sketch.quantile(1.0 - kClipQuantile);
+        return statistics;
+    }
+
+    std::vector<float> buffer(values, values + count);
+    const std::size_t middle = rank(0.5);
+    const std::size_t lower = rank(kClipQuantile);
+    const std::size_t upper = rank(1.0 - kClipQuantile);
+
+    // After the median selection the clip quantiles lie in the partitions on either side
+    std::nth_element(buffer.begin(), buffer.begin() + middle, buffer.end());
+    statistics.median = buffer[middle];
+    if (lower < middle)
+        std::nth_element(buffer.begin(), buffer.begin() + lower, buffer.begin() + middle);
+    statistics.lower = buffer[lower];
+    if (upper > middle)
+        std::nth_element(buffer.begin() + middle + 1, buffer.begin() + upper, buffer.end());
+    statistics.upper = buffer[upper];
+
+    for (auto& value : buffer)
+        value = std::abs(value - statistics.median);
+    std::nth_element(buffer.begin(), buffer.begin() + middle, buffer.end());
+    statistics.mad = buffer[middle];
+    return statistics;
+}
+
+SeriesRobustStatistics computeSeriesRobustStatistics(const LineSeries& data)
+{
+    SeriesRobustStatistics statistics;
+    const std::size_t n = data.size();
+
+    // Selection is sequential per column, so exact columns run side by side; sketches parallelize internally
+    if (n <= kExactSelectionLimit) {
+        parallelForChunks(2, 2, [&](std::size_t column, std::size_t, std::size_t) {
+            if (column == 0)
+                statistics.x = computeRobustStatistics(data.xData(), n);
+            else
+                statistics.y = computeRobustStatistics(data.yData(), n);
+            });
+    }
+    else {
+        statistics.x = computeRobustStatistics(data.xData(), n);
+        statistics.y = computeRobustStatistics(data.yData(), n);
+    }
+    return statistics;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "../libs/LineChartLib/LineSeries.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+/**
+ * Count, mean, sum of squared deviations and range of one column
+ *
+ * Partial results of disjoint ranges are combined with merge(), using the
+ * pairwise update of Chan et al., so blocks can be reduced independently
+ * and in any grouping without losing the stability of Welford's method.
+ */
+struct ColumnStatistics
+{
+    std::size_t count = 0;
+    double      mean = 0.0;
+    double      m2 = 0.0;       // Sum of squared deviations from the mean
+    float       min = std::numeric_limits<float>::max();
+    float       max = -std::numeric_limits<float>::max();
+
+    /** Population variance */
+    double variance() const { return count > 0 ? m2 / static_cast<double>(count) : 0.0; }
+
+    /** Largest absolute value */
+    float maxAbs() const { return count > 0 ? std::max(-min, max) : 0.0f; }
+
+    /** Combine with the statistics of a disjoint range */
+    void merge(const ColumnStatistics& other);
+
+    /** Turn into the statistics of (value - offset) * scale, \p scale must be positive */
+    void transform(float offset, float scale);
+};
+
+/**
+ * Statistics of a line series
+ *
+ * Besides the whole series, the first and last ceil(n / 2) points are kept
+ * separately; they are what the stat line is drawn between.
+ */
+struct SeriesStatistics
+{
+    ColumnStatistics x, y;
+    double           coMoment = 0.0;    // Sum of (x - mean x) * (y - mean y)
+    ColumnStatistics headX, headY;
+    ColumnStatistics tailX, tailY;
+
+    std::size_t size() const { return x.count; }
+
+    /** Apply the affine maps of applyNormalization() to every member */
+    void transform(float xOffset, float xScale, float yOffset, float yScale);
+};
+
+/**
+ * Statistics of both columns of \p data, including the head and tail halves, in one pass
+ *
+ * The points are processed in cache sized blocks: sum, minimum and maximum of a
+ * block come from plain loops the compiler vectorizes, the squared deviations
+ * and the co-moment from further loops over the block while it is still in
+ * cache, and the blocks are merged. Chunks of blocks run in parallel on the
+ * global thread pool.
+ */
+SeriesStatistics computeSeriesStatistics(const LineSeries& data);
+
+/** Statistics of \p count values, block-wise and in parallel like computeSeriesStatistics() */
+ColumnStatistics computeColumnStatistics(const float* values, std::size_t count);
+
+/** Median, median absolute deviation and clip range of one column */
+struct RobustStatistics
+{
+    float   median = 0.0f;
+    float   mad = 0.0f;
+    float   lower = 0.0f;       // Quantile kClipQuantile
+    float   upper = 0.0f;       // Quantile 1 - kClipQuantile
+};
+
+/** Robust statistics of both columns of a series */
+struct SeriesRobustStatistics
+{
+    RobustStatistics x, y;
+};
+
+// Tail fraction cut off on either side by quantile clipping
+constexpr float kClipQuantile = 0.01f;
+
+// Columns up to this size are summarized exactly, larger ones through a QuantileSketch
+constexpr std::size_t kExactSelectionLimit = std::size_t(1) << 24;
+
+/**
+ * Robust statistics of \p count values
+ *
+ * Up to kExactSelectionLimit values the quantiles are exact: a copy is partitioned
+ * with nth_element around the median, the clip quantiles are selected from the
+ * halves on either side, and the absolute deviations are selected in place. Larger
+ * columns are summarized by a block-wise built QuantileSketch instead, which needs
+ * no copy and a single streaming pass.
+ */
+RobustStatistics computeRobustStatistics(const float* values, std::size_t count);
+
+/** Robust statistics of both columns of \p data, the columns are selected in parallel */
+SeriesRobustStatistics computeSeriesRobustStatistics(const LineSeries& data);
@@ -3,12 +3,14 @@
 #include <iostream>
 #include <set>
 #include "LinePlotViewPlugin.h"
+#include "SmoothingFilters.h"
 #include <string>
 #include <QFileDialog>
 #include <QPageLayout>
 #include <QWebEngineView>
 #include <chrono>
 #include <typeinfo>
+#include <utility>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
@@ -32,17 +34,32 @@ SettingsAction::SettingsAction(LinePlotViewPlugin& LinePlotViewPlugin) :
 
     _datasetOptionsHolder.getDataDimensionXSelectionAction().setSerializationName("LayerSurfer:DataDimensionXSelection");
     _datasetOptionsHolder.getDataDimensionYSelectionAction().setSerializationName("LayerSurfer:DataDimensionYSelection");
+    _datasetOptionsHolder.getOverlayDimensionsAction().setSerializationName("LayerSurfer:OverlayDimensions");
     _datasetOptionsHolder.getColorPointDatasetDimensionAction().setSerializationName("LayerSurfer:ColorPointDatasetDimension");
     _chartOptionsHolder.getPointDatasetDimensionColorMapAction().setSerializationName("LayerSurfer:PointDatasetDimensionColorMap");
 
     _chartOptionsHolder.getSmoothingTypeAction().setSerializationName("LayerSurfer:SmoothingType");
     _chartOptionsHolder.getNormalizationTypeAction().setSerializationName("LayerSurfer:NormalizationType");
     _chartOptionsHolder.getSmoothingWindowAction().setSerializationName("LayerSurfer:SmoothingWindow");
+    _chartOptionsHolder.getPolynomialOrderAction().setSerializationName("LayerSurfer:PolynomialOrder");
+    _chartOptionsHolder.getDerivativeOrderAction().setSerializationName("LayerSurfer:DerivativeOrder");
+    _chartOptionsHolder.getQuantileAction().setSerializationName("LayerSurfer:Quantile");
+    _chartOptionsHolder.getSplineBandwidthAction().setSerializationName("LayerSurfer:SplineBandwidth");
+    _chartOptionsHolder.getXWindowWidthAction().setSerializationName("LayerSurfer:XWindowWidth");
+    _chartOptionsHolder.getLowessSpanAction().setSerializationName("LayerSurfer:LowessSpan");
+    _chartOptionsHolder.getRobustnessIterationsAction().setSerializationName("LayerSurfer:RobustnessIterations");
+    _chartOptionsHolder.getLowessGridSizeAction().setSerializationName("LayerSurfer:LowessGridSize");
     _chartOptionsHolder.getChartTitleAction().setSerializationName("LayerSurfer:ChartTitle");
     _chartOptionsHolder.getSwitchAxesAction().setSerializationName("LayerSurfer:SwitchAxes");
     _chartOptionsHolder.getSortByAxisAction().setSerializationName("LayerSurfer:SortByAxis");
     _chartOptionsHolder.getShowEnvelopeAction().setSerializationName("LayerSurfer:ShowEnvelope");
     _chartOptionsHolder.getShowStatLineAction().setSerializationName("LayerSurfer:ShowStatLine");
+    _chartOptionsHolder.getStatLineTypeAction().setSerializationName("LayerSurfer:StatLineType");
+    _chartOptionsHolder.getChangePointCostAction().setSerializationName("LayerSurfer:ChangePointCost");
+    _chartOptionsHolder.getChangePointPenaltyAction().setSerializationName("LayerSurfer:ChangePointPenalty");
+    _chartOptionsHolder.getXAggregationAction().setSerializationName("LayerSurfer:XAggregation");
+    _chartOptionsHolder.getXBinWidthAction().setSerializationName("LayerSurfer:XBinWidth");
+    _chartOptionsHolder.getDownsamplingModeAction().setSerializationName("LayerSurfer:DownsamplingMode");
 
     _datasetOptionsHolder.getPointDatasetAction().setToolTip("Point Dataset");
     _datasetOptionsHolder.getColorDatasetAction().setToolTip("Cluster Dataset");
@@ -50,17 +67,32 @@ SettingsAction::SettingsAction(LinePlotViewPlugin& LinePlotViewPlugin) :
 
     _datasetOptionsHolder.getDataDimensionXSelectionAction().setToolTip("Data Dimension X Selection");
     _datasetOptionsHolder.getDataDimensionYSelectionAction().setToolTip("Data Dimension Y Selection");
+    _datasetOptionsHolder.getOverlayDimensionsAction().setToolTip("Further Y dimensions drawn over the main line, sorted and smoothed the same way");
     _datasetOptionsHolder.getColorPointDatasetDimensionAction().setToolTip("Color Point Dataset Dimension");
     _chartOptionsHolder.getPointDatasetDimensionColorMapAction().setToolTip("Point Dataset Dimension Color Map");
 
     _chartOptionsHolder.getSmoothingTypeAction().setToolTip("Smoothing Type");
-    _chartOptionsHolder.getNormalizationTypeAction().setToolTip("Normalization Type");
+    _chartOptionsHolder.getNormalizationTypeAction().setToolTip("Normalization Type; Median/MAD and Quantile Clip are robust against outliers");
     _chartOptionsHolder.getSmoothingWindowAction().setToolTip("Smoothing Window");
+    _chartOptionsHolder.getPolynomialOrderAction().setToolTip("Savitzky-Golay polynomial order");
+    _chartOptionsHolder.getDerivativeOrderAction().setToolTip("Savitzky-Golay derivative order, 0 smooths the line itself");
+    _chartOptionsHolder.getQuantileAction().setToolTip("Quantile taken over each window by the running quantile, 0.5 is the median");
+    _chartOptionsHolder.getSplineBandwidthAction().setToolTip("Cubic spline smoothing scale in point spacings, 0 interpolates the data");
+    _chartOptionsHolder.getXWindowWidthAction().setToolTip("Window width of the X-window smoothers, in units of the (normalized) X axis");
+    _chartOptionsHolder.getLowessSpanAction().setToolTip("Fraction of the points LOWESS fits each local line to");
+    _chartOptionsHolder.getRobustnessIterationsAction().setToolTip("LOWESS refits that down-weight outliers");
+    _chartOptionsHolder.getLowessGridSizeAction().setToolTip("Number of evenly spaced X positions LOWESS is evaluated at, 0 evaluates at every point");
     _chartOptionsHolder.getChartTitleAction().setToolTip("Chart Title");
     _chartOptionsHolder.getSwitchAxesAction().setToolTip("Switch Axes");
     _chartOptionsHolder.getShowEnvelopeAction().setToolTip("Show Envelope");
     _chartOptionsHolder.getSortByAxisAction().setToolTip("Sort By Axis");
     _chartOptionsHolder.getShowStatLineAction().setToolTip("Show Stat Line");
+    _chartOptionsHolder.getChangePointCostAction().setToolTip("Mark change points of the normalized line, where its mean or its mean and variance shift");
+    _chartOptionsHolder.getChangePointPenaltyAction().setToolTip("Cost of a change point in units of log(n); higher values mark fewer changes, 2 is the BIC");
+    _chartOptionsHolder.getXAggregationAction().setToolTip("Collapse the points that share an X value, or an X bin, into one point; the line shows the chosen statistic and a band the Y range of each group");
+    _chartOptionsHolder.getXBinWidthAction().setToolTip("Width of the X bins points are grouped in, in plotted X units; 0 groups equal X values");
+    _chartOptionsHolder.getStatLineTypeAction().setToolTip("Stat line: means of the first and last half, a least squares fit or a Theil-Sen fit robust against outliers; the fits show the 95% interval of their slope. Theil-Sen fits series above about 500,000 points on an evenly spread subsample of that size");
+    _chartOptionsHolder.getDownsamplingModeAction().setToolTip("Downsampling used when the line has more points than pixels: M4 is pixel exact, LTTB favors the visual shape");
 
     _datasetOptionsHolder.getPointDatasetAction().setFilterFunction([this](mv::Dataset<DatasetImpl> dataset) -> bool {
         return dataset->getDataType() == PointType;
@@ -70,6 +102,7 @@ SettingsAction::SettingsAction(LinePlotViewPlugin& LinePlotViewPlugin) :
     _datasetOptionsHolder.getColorDatasetAction().setDefaultWidgetFlags(OptionAction::ComboBox);
     _datasetOptionsHolder.getDataDimensionXSelectionAction().setDefaultWidgetFlags(OptionAction::ComboBox);
     _datasetOptionsHolder.getDataDimensionYSelectionAction().setDefaultWidgetFlags(OptionAction::ComboBox);
+    _datasetOptionsHolder.getOverlayDimensionsAction().setDefaultWidgetFlags(OptionsAction::ComboBox);
     _datasetOptionsHolder.getColorPointDatasetDimensionAction().setDefaultWidgetFlags(OptionAction::ComboBox);
     _chartOptionsHolder.getPointDatasetDimensionColorMapAction().setDefaultWidgetFlags(OptionAction::ComboBox);
     _datasetOptionsHolder.getColorPointDatasetDimensionAction().setDisabled(true);
@@ -77,6 +110,14 @@ SettingsAction::SettingsAction(LinePlotViewPlugin& LinePlotViewPlugin) :
     _chartOptionsHolder.getSmoothingTypeAction().setDefaultWidgetFlags(OptionAction::ComboBox);
     _chartOptionsHolder.getNormalizationTypeAction().setDefaultWidgetFlags(OptionAction::ComboBox);
     _chartOptionsHolder.getSmoothingWindowAction().setDefaultWidgetFlags(IntegralAction::SpinBox | IntegralAction::Slider);
+    _chartOptionsHolder.getPolynomialOrderAction().setDefaultWidgetFlags(IntegralAction::SpinBox);
+    _chartOptionsHolder.getDerivativeOrderAction().setDefaultWidgetFlags(IntegralAction::SpinBox);
+    _chartOptionsHolder.getQuantileAction().setDefaultWidgetFlags(DecimalAction::SpinBox | DecimalAction::Slider);
+    _chartOptionsHolder.getSplineBandwidthAction().setDefaultWidgetFlags(DecimalAction::SpinBox);
+    _chartOptionsHolder.getXWindowWidthAction().setDefaultWidgetFlags(DecimalAction::SpinBox);
+    _chartOptionsHolder.getLowessSpanAction().setDefaultWidgetFlags(DecimalAction::SpinBox | DecimalAction::Slider);
+    _chartOptionsHolder.getRobustnessIterationsAction().setDefaultWidgetFlags(IntegralAction::SpinBox);
+    _chartOptionsHolder.getLowessGridSizeAction().setDefaultWidgetFlags(IntegralAction::SpinBox);
     _chartOptionsHolder.getChartTitleAction().setDefaultWidgetFlags(OptionAction::LineEdit);
     _chartOptionsHolder.getChartTitleAction().setString("");
     _chartOptionsHolder.getSwitchAxesAction().setDefaultWidgetFlags(ToggleAction::CheckBox);
@@ -85,8 +126,18 @@ SettingsAction::SettingsAction(LinePlotViewPlugin& LinePlotViewPlugin) :
     _chartOptionsHolder.getShowEnvelopeAction().setChecked(true);
     _chartOptionsHolder.getShowStatLineAction().setDefaultWidgetFlags(ToggleAction::CheckBox);
     _chartOptionsHolder.getShowStatLineAction().setChecked(false);
+    _chartOptionsHolder.getStatLineTypeAction().setDefaultWidgetFlags(OptionAction::ComboBox);
+    _chartOptionsHolder.getStatLineTypeAction().initialize(QStringList{ "Two Means", "Least Squares", "Theil-Sen" }, "Least Squares");
+    _chartOptionsHolder.getChangePointCostAction().setDefaultWidgetFlags(OptionAction::ComboBox);
+    _chartOptionsHolder.getChangePointCostAction().initialize(QStringList{ "Off", "Mean", "Mean and Variance" }, "Off");
+    _chartOptionsHolder.getChangePointPenaltyAction().setDefaultWidgetFlags(DecimalAction::SpinBox | DecimalAction::Slider);
+    _chartOptionsHolder.getXAggregationAction().setDefaultWidgetFlags(OptionAction::ComboBox);
+    _chartOptionsHolder.getXAggregationAction().initialize(QStringList{ "Off", "Mean", "Median", "Min", "Max", "Count" }, "Off");
+    _chartOptionsHolder.getXBinWidthAction().setDefaultWidgetFlags(DecimalAction::SpinBox);
     _chartOptionsHolder.getSortByAxisAction().setDefaultWidgetFlags(OptionAction::ComboBox);
     _chartOptionsHolder.getSortByAxisAction().initialize(QStringList{ "X", "Y" }, "X");
+    _chartOptionsHolder.getDownsamplingModeAction().setDefaultWidgetFlags(OptionAction::ComboBox);
+    _chartOptionsHolder.getDownsamplingModeAction().initialize(QStringList{ "M4", "LTTB" }, "M4");
     _initDisplayMessageAction.setDefaultWidgetFlags(OptionAction::LineEdit);
     _initDisplayMessageAction.setString("No data available or insufficient data for chart.");
     //_initDisplayMessageAction.setString("Draw a line on a scatterplot to begin exploration.");
@@ -113,23 +164,97 @@ SettingsAction::SettingsAction(LinePlotViewPlugin& LinePlotViewPlugin) :
     _chartOptionsHolder.getSmoothingWindowAction().setMaximum(1000);
     _chartOptionsHolder.getSmoothingWindowAction().setValue(5);
 
-    _chartOptionsHolder.getSmoothingTypeAction().initialize(QStringList{
-        "None",
-        "Moving Average",
-        "Savitzky-Golay",
-        "Gaussian",
-        "Exponential Moving Average",
-        "Cubic Spline",
-        "Linear Interpolation",
-        "Min-Max Sampling",
-        "Running Median"
-        }, "Moving Average");
+    _chartOptionsHolder.getPolynomialOrderAction().setMinimum(0);
+    _chartOptionsHolder.getPolynomialOrderAction().setMaximum(6);
+    _chartOptionsHolder.getPolynomialOrderAction().setValue(2);
+    _chartOptionsHolder.getDerivativeOrderAction().setMinimum(0);
+    _chartOptionsHolder.getDerivativeOrderAction().setMaximum(3);
+    _chartOptionsHolder.getDerivativeOrderAction().setValue(0);
+
+    _chartOptionsHolder.getQuantileAction().setMinimum(0.0f);
+    _chartOptionsHolder.getQuantileAction().setMaximum(1.0f);
+    _chartOptionsHolder.getQuantileAction().setSingleStep(0.01f);
+    _chartOptionsHolder.getQuantileAction().setNumberOfDecimals(2);
+    _chartOptionsHolder.getQuantileAction().setValue(0.9f);
+
+    _chartOptionsHolder.getSplineBandwidthAction().setMinimum(0.0f);
+    _chartOptionsHolder.getSplineBandwidthAction().setMaximum(10000.0f);
+    _chartOptionsHolder.getSplineBandwidthAction().setSingleStep(1.0f);
+    _chartOptionsHolder.getSplineBandwidthAction().setNumberOfDecimals(1);
+    _chartOptionsHolder.getSplineBandwidthAction().setValue(10.0f);
+
+    _chartOptionsHolder.getXWindowWidthAction().setMinimum(0.0f);
+    _chartOptionsHolder.getXWindowWidthAction().setMaximum(1000000.0f);
+    _chartOptionsHolder.getXWindowWidthAction().setSingleStep(0.1f);
+    _chartOptionsHolder.getXWindowWidthAction().setNumberOfDecimals(4);
+    _chartOptionsHolder.getXWindowWidthAction().setValue(1.0f);
+
+    _chartOptionsHolder.getLowessSpanAction().setMinimum(0.001f);
+    _chartOptionsHolder.getLowessSpanAction().setMaximum(1.0f);
+    _chartOptionsHolder.getLowessSpanAction().setSingleStep(0.01f);
+    _chartOptionsHolder.getLowessSpanAction().setNumberOfDecimals(3);
+    _chartOptionsHolder.getLowessSpanAction().setValue(0.1f);
+    _chartOptionsHolder.getRobustnessIterationsAction().setMinimum(0);
+    _chartOptionsHolder.getRobustnessIterationsAction().setMaximum(5);
+    _chartOptionsHolder.getRobustnessIterationsAction().setValue(2);
+    _chartOptionsHolder.getChangePointPenaltyAction().setMinimum(0.1f);
+    _chartOptionsHolder.getChangePointPenaltyAction().setMaximum(50.0f);
+    _chartOptionsHolder.getChangePointPenaltyAction().setSingleStep(0.5f);
+    _chartOptionsHolder.getChangePointPenaltyAction().setNumberOfDecimals(1);
+    _chartOptionsHolder.getChangePointPenaltyAction().setValue(2.0f);
+    _chartOptionsHolder.getXBinWidthAction().setMinimum(0.0f);
+    _chartOptionsHolder.getXBinWidthAction().setMaximum(1000000.0f);
+    _chartOptionsHolder.getXBinWidthAction().setSingleStep(0.1f);
+    _chartOptionsHolder.getXBinWidthAction().setNumberOfDecimals(4);
+    _chartOptionsHolder.getXBinWidthAction().setValue(0.0f);
+    _chartOptionsHolder.getLowessGridSizeAction().setMinimum(0);
+    _chartOptionsHolder.getLowessGridSizeAction().setMaximum(100000);
+    _chartOptionsHolder.getLowessGridSizeAction().setValue(1000);
+
+    _chartOptionsHolder.getSmoothingTypeAction().initialize(smoothingFilterNames(), "Moving Average");
     _chartOptionsHolder.getNormalizationTypeAction().initialize(QStringList{
         "None",
         "Z-Score",
         "Min-Max",
-        "DecimalScaling"
+        "DecimalScaling",
+        "Median/MAD",
+        "Quantile Clip (1-99%)"
         }, "None");
+
+    // Only the settings the selected filter reads are editable
+    const auto updateSmoothingParameterActions = [this]() -> void {
+        const auto smoothing = smoothingTypeFromName(_chartOptionsHolder.getSmoothingTypeAction().getCurrentText()).value_or(SmoothingType::None);
+        const std::pair<SmoothingParameter, WidgetAction*> parameterActions[] = {
+            { SmoothingParameter::WindowSize, &_chartOptionsHolder.getSmoothingWindowAction() },
+            { SmoothingParameter::PolynomialOrder, &_chartOptionsHolder.getPolynomialOrderAction() },
+            { SmoothingParameter::DerivativeOrder, &_chartOptionsHolder.getDerivativeOrderAction() },
+            { SmoothingParameter::Quantile, &_chartOptionsHolder.getQuantileAction() },
+            { SmoothingParameter::SplineBandwidth, &_chartOptionsHolder.getSplineBandwidthAction() },
+            { SmoothingParameter::XWindowWidth, &_chartOptionsHolder.getXWindowWidthAction() },
+            { SmoothingParameter::LowessSpan, &_chartOptionsHolder.getLowessSpanAction() },
+            { SmoothingParameter::RobustnessIterations, &_chartOptionsHolder.getRobustnessIterationsAction() },
+            { SmoothingParameter::LowessGridSize, &_chartOptionsHolder.getLowessGridSizeAction() }
+        };
+        for (const auto& [parameter, action] : parameterActions)
+            action->setEnabled(smoothingFilterReads(smoothing, parameter));
+        };
+
+    updateSmoothingParameterActions();
+    connect(&_chartOptionsHolder.getSmoothingTypeAction(), &OptionAction::currentIndexChanged, this, updateSmoothingParameterActions);
+
+    const auto updateChangePointPenaltyAction = [this]() -> void {
+        _chartOptionsHolder.getChangePointPenaltyAction().setEnabled(_chartOptionsHolder.getChangePointCostAction().getCurrentText() != "Off");
+        };
+
+    updateChangePointPenaltyAction();
+    connect(&_chartOptionsHolder.getChangePointCostAction(), &OptionAction::currentIndexChanged, this, updateChangePointPenaltyAction);
+
+    const auto updateXBinWidthAction = [this]() -> void {
+        _chartOptionsHolder.getXBinWidthAction().setEnabled(_chartOptionsHolder.getXAggregationAction().getCurrentText() != "Off");
+        };
+
+    updateXBinWidthAction();
+    connect(&_chartOptionsHolder.getXAggregationAction(), &OptionAction::currentIndexChanged, this, updateXBinWidthAction);
 }
 
 inline SettingsAction::DatasetOptionsHolder::DatasetOptionsHolder(SettingsAction& settingsAction) :
@@ -138,6 +263,7 @@ inline SettingsAction::DatasetOptionsHolder::DatasetOptionsHolder(SettingsAction
     _pointDatasetAction(this, "Point dataset"),
     _dataDimensionXSelectionAction(this, "Data Dimension X Selection"),
     _dataDimensionYSelectionAction(this, "Data Dimension Y Selection"),
+    _overlayDimensionsAction(this, "Overlay Dimensions"),
     _colorDatasetAction(this, "Color dataset"),
     _colorPointDatasetDimensionAction(this, "Color Point Dataset Dimension")
 {
@@ -148,6 +274,7 @@ inline SettingsAction::DatasetOptionsHolder::DatasetOptionsHolder(SettingsAction
     addAction(&_pointDatasetAction);
     addAction(&_dataDimensionXSelectionAction);
     addAction(&_dataDimensionYSelectionAction);
+    addAction(&_overlayDimensionsAction);
     addAction(&_colorDatasetAction);
     addAction(&_colorPointDatasetDimensionAction);
     
@@ -161,6 +288,14 @@ inline SettingsAction::ChartOptionsHolder::ChartOptionsHolder(SettingsAction& se
     _smoothingTypeAction(this, "Smoothing Type"),
     _normalizationTypeAction(this, "Normalization Type"),
     _smoothingWindowAction(this, "Smoothing Window"),
+    _polynomialOrderAction(this, "Polynomial Order"),
+    _derivativeOrderAction(this, "Derivative Order"),
+    _quantileAction(this, "Quantile"),
+    _splineBandwidthAction(this, "Spline Bandwidth"),
+    _xWindowWidthAction(this, "X Window Width"),
+    _lowessSpanAction(this, "LOWESS Span"),
+    _robustnessIterationsAction(this, "Robustness Iterations"),
+    _lowessGridSizeAction(this, "LOWESS Grid Size"),
     _chartTitleAction(this, "Chart Title"),
     _pointDatasetDimensionColorMapAction(this, "Point Dataset Dimension Color Map"),
     _lowerColorLimitAction(this, "Lower Color Limit"),
@@ -168,7 +303,13 @@ inline SettingsAction::ChartOptionsHolder::ChartOptionsHolder(SettingsAction& se
     _switchAxesAction(this, "Switch Axes"),
     _sortByAxisAction(this, "Sort By Axis"),
     _showEnvelopeAction(this, "Show Envelope"),
-    _showStatLineAction(this, "Show Stat Line")
+    _showStatLineAction(this, "Show Stat Line"),
+    _statLineTypeAction(this, "Stat Line Type"),
+    _changePointCostAction(this, "Change Points"),
+    _changePointPenaltyAction(this, "Change Point Penalty"),
+    _xAggregationAction(this, "Group By X"),
+    _xBinWidthAction(this, "X Bin Width"),
+    _downsamplingModeAction(this, "Downsampling")
 {
     setText("Dataset1 Options");
     setIcon(mv::util::StyledIcon("database"));
@@ -176,13 +317,27 @@ inline SettingsAction::ChartOptionsHolder::ChartOptionsHolder(SettingsAction& se
     setConfigurationFlag(WidgetAction::ConfigurationFlag::Default);
     addAction(&_smoothingTypeAction);
     addAction(&_smoothingWindowAction);
+    addAction(&_polynomialOrderAction);
+    addAction(&_derivativeOrderAction);
+    addAction(&_quantileAction);
+    addAction(&_splineBandwidthAction);
+    addAction(&_xWindowWidthAction);
+    addAction(&_lowessSpanAction);
+    addAction(&_robustnessIterationsAction);
+    addAction(&_lowessGridSizeAction);
     addAction(&_normalizationTypeAction);
+    addAction(&_xAggregationAction);
+    addAction(&_xBinWidthAction);
     addAction(&_chartTitleAction);
     addAction(&_pointDatasetDimensionColorMapAction);
     addAction(&_upperColorLimitAction);
     addAction(&_lowerColorLimitAction);
     addAction(&_showEnvelopeAction);
     addAction(&_showStatLineAction);
+    addAction(&_statLineTypeAction);
+    addAction(&_changePointCostAction);
+    addAction(&_changePointPenaltyAction);
+    addAction(&_downsamplingModeAction);
     //addAction(&_switchAxesAction);
     //addAction(&_sortByAxisAction);
 }
@@ -194,15 +349,30 @@ void SettingsAction::fromVariantMap(const QVariantMap& variantMap)
     _datasetOptionsHolder.getColorDatasetAction().fromParentVariantMap(variantMap);
     _datasetOptionsHolder.getDataDimensionXSelectionAction().fromParentVariantMap(variantMap);
     _datasetOptionsHolder.getDataDimensionYSelectionAction().fromParentVariantMap(variantMap);
+    _datasetOptionsHolder.getOverlayDimensionsAction().fromParentVariantMap(variantMap, true);
     _chartOptionsHolder.getSmoothingTypeAction().fromParentVariantMap(variantMap);
     _chartOptionsHolder.getNormalizationTypeAction().fromParentVariantMap(variantMap);
     _chartOptionsHolder.getSmoothingWindowAction().fromParentVariantMap(variantMap);
+    _chartOptionsHolder.getPolynomialOrderAction().fromParentVariantMap(variantMap, true);
+    _chartOptionsHolder.getDerivativeOrderAction().fromParentVariantMap(variantMap, true);
+    _chartOptionsHolder.getQuantileAction().fromParentVariantMap(variantMap, true);
+    _chartOptionsHolder.getSplineBandwidthAction().fromParentVariantMap(variantMap, true);
+    _chartOptionsHolder.getXWindowWidthAction().fromParentVariantMap(variantMap, true);
+    _chartOptionsHolder.getLowessSpanAction().fromParentVariantMap(variantMap, true);
+    _chartOptionsHolder.getRobustnessIterationsAction().fromParentVariantMap(variantMap, true);
+    _chartOptionsHolder.getLowessGridSizeAction().fromParentVariantMap(variantMap, true);
     _chartOptionsHolder.getChartTitleAction().fromParentVariantMap(variantMap);
     _datasetOptionsHolder.getColorPointDatasetDimensionAction().fromParentVariantMap(variantMap);
     _chartOptionsHolder.getPointDatasetDimensionColorMapAction().fromParentVariantMap(variantMap);
     _chartOptionsHolder.getSwitchAxesAction().fromParentVariantMap(variantMap);
     _chartOptionsHolder.getShowEnvelopeAction().fromParentVariantMap(variantMap);
     _chartOptionsHolder.getShowStatLineAction().fromParentVariantMap(variantMap);
+    _chartOptionsHolder.getStatLineTypeAction().fromParentVariantMap(variantMap, true);
+    _chartOptionsHolder.getChangePointCostAction().fromParentVariantMap(variantMap, true);
+    _chartOptionsHolder.getChangePointPenaltyAction().fromParentVariantMap(variantMap, true);
+    _chartOptionsHolder.getXAggregationAction().fromParentVariantMap(variantMap, true);
+    _chartOptionsHolder.getXBinWidthAction().fromParentVariantMap(variantMap, true);
+    _chartOptionsHolder.getDownsamplingModeAction().fromParentVariantMap(variantMap, true);
     _chartOptionsHolder.getSortByAxisAction().fromParentVariantMap(variantMap);
     _initDisplayMessageAction.fromParentVariantMap(variantMap);
 }
@@ -214,15 +384,30 @@ QVariantMap SettingsAction::toVariantMap() const
     _datasetOptionsHolder.getColorDatasetAction().insertIntoVariantMap(variantMap);
     _datasetOptionsHolder.getDataDimensionXSelectionAction().insertIntoVariantMap(variantMap);
     _datasetOptionsHolder.getDataDimensionYSelectionAction().insertIntoVariantMap(variantMap);
+    _datasetOptionsHolder.getOverlayDimensionsAction().insertIntoVariantMap(variantMap);
     _chartOptionsHolder.getSmoothingTypeAction().insertIntoVariantMap(variantMap);
     _chartOptionsHolder.getNormalizationTypeAction().insertIntoVariantMap(variantMap);
     _chartOptionsHolder.getSmoothingWindowAction().insertIntoVariantMap(variantMap);
+    _chartOptionsHolder.getPolynomialOrderAction().insertIntoVariantMap(variantMap);
+    _chartOptionsHolder.getDerivativeOrderAction().insertIntoVariantMap(variantMap);
+    _chartOptionsHolder.getQuantileAction().insertIntoVariantMap(variantMap);
+    _chartOptionsHolder.getSplineBandwidthAction().insertIntoVariantMap(variantMap);
+    _chartOptionsHolder.getXWindowWidthAction().insertIntoVariantMap(variantMap);
+    _chartOptionsHolder.getLowessSpanAction().insertIntoVariantMap(variantMap);
+    _chartOptionsHolder.getRobustnessIterationsAction().insertIntoVariantMap(variantMap);
+    _chartOptionsHolder.getLowessGridSizeAction().insertIntoVariantMap(variantMap);
     _chartOptionsHolder.getChartTitleAction().insertIntoVariantMap(variantMap);
     _datasetOptionsHolder.getColorPointDatasetDimensionAction().insertIntoVariantMap(variantMap);
     _chartOptionsHolder.getPointDatasetDimensionColorMapAction().insertIntoVariantMap(variantMap);
     _chartOptionsHolder.getSwitchAxesAction().insertIntoVariantMap(variantMap);
     _chartOptionsHolder.getShowEnvelopeAction().insertIntoVariantMap(variantMap);
     _chartOptionsHolder.getShowStatLineAction().insertIntoVariantMap(variantMap);
+    _chartOptionsHolder.getStatLineTypeAction().insertIntoVariantMap(variantMap);
+    _chartOptionsHolder.getChangePointCostAction().insertIntoVariantMap(variantMap);
+    _chartOptionsHolder.getChangePointPenaltyAction().insertIntoVariantMap(variantMap);
+    _chartOptionsHolder.getXAggregationAction().insertIntoVariantMap(variantMap);
+    _chartOptionsHolder.getXBinWidthAction().insertIntoVariantMap(variantMap);
+    _chartOptionsHolder.getDownsamplingModeAction().insertIntoVariantMap(variantMap);
     _chartOptionsHolder.getSortByAxisAction().insertIntoVariantMap(variantMap);
     _initDisplayMessageAction.insertIntoVariantMap(variantMap);
 
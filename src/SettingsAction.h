@@ -72,6 +72,9 @@ public:
         const DatasetPickerAction& getColorDatasetAction() const { return _colorDatasetAction; }
         DatasetPickerAction& getColorDatasetAction() { return _colorDatasetAction; }
 
+        const OptionsAction& getOverlayDimensionsAction() const { return _overlayDimensionsAction; }
+        OptionsAction& getOverlayDimensionsAction() { return _overlayDimensionsAction; }
+
         
 
     protected:
@@ -81,6 +84,7 @@ public:
         DimensionPickerAction   _colorPointDatasetDimensionAction;
         DimensionPickerAction   _dataDimensionXSelectionAction;
         DimensionPickerAction   _dataDimensionYSelectionAction;
+        OptionsAction           _overlayDimensionsAction;
         
 
     };
@@ -98,6 +102,22 @@ public:
         OptionAction& getNormalizationTypeAction() { return _normalizationTypeAction; }
         const IntegralAction& getSmoothingWindowAction() const { return _smoothingWindowAction; }
         IntegralAction& getSmoothingWindowAction() { return _smoothingWindowAction; }
+        const IntegralAction& getPolynomialOrderAction() const { return _polynomialOrderAction; }
+        IntegralAction& getPolynomialOrderAction() { return _polynomialOrderAction; }
+        const IntegralAction& getDerivativeOrderAction() const { return _derivativeOrderAction; }
+        IntegralAction& getDerivativeOrderAction() { return _derivativeOrderAction; }
+        const DecimalAction& getQuantileAction() const { return _quantileAction; }
+        DecimalAction& getQuantileAction() { return _quantileAction; }
+        const DecimalAction& getSplineBandwidthAction() const { return _splineBandwidthAction; }
+        DecimalAction& getSplineBandwidthAction() { return _splineBandwidthAction; }
+        const DecimalAction& getXWindowWidthAction() const { return _xWindowWidthAction; }
+        DecimalAction& getXWindowWidthAction() { return _xWindowWidthAction; }
+        const DecimalAction& getLowessSpanAction() const { return _lowessSpanAction; }
+        DecimalAction& getLowessSpanAction() { return _lowessSpanAction; }
+        const IntegralAction& getRobustnessIterationsAction() const { return _robustnessIterationsAction; }
+        IntegralAction& getRobustnessIterationsAction() { return _robustnessIterationsAction; }
+        const IntegralAction& getLowessGridSizeAction() const { return _lowessGridSizeAction; }
+        IntegralAction& getLowessGridSizeAction() { return _lowessGridSizeAction; }
 
         const StringAction& getChartTitleAction() const { return _chartTitleAction; }
         StringAction& getChartTitleAction() { return _chartTitleAction; }
@@ -118,6 +138,19 @@ public:
 
         const ToggleAction& getShowStatLineAction() const { return _showStatLineAction; }
         ToggleAction& getShowStatLineAction() { return _showStatLineAction; }
+        const OptionAction& getStatLineTypeAction() const { return _statLineTypeAction; }
+        OptionAction& getStatLineTypeAction() { return _statLineTypeAction; }
+        const OptionAction& getChangePointCostAction() const { return _changePointCostAction; }
+        OptionAction& getChangePointCostAction() { return _changePointCostAction; }
+        const DecimalAction& getChangePointPenaltyAction() const { return _changePointPenaltyAction; }
+        DecimalAction& getChangePointPenaltyAction() { return _changePointPenaltyAction; }
+        const OptionAction& getXAggregationAction() const { return _xAggregationAction; }
+        OptionAction& getXAggregationAction() { return _xAggregationAction; }
+        const DecimalAction& getXBinWidthAction() const { return _xBinWidthAction; }
+        DecimalAction& getXBinWidthAction() { return _xBinWidthAction; }
+
+        const OptionAction& getDownsamplingModeAction() const { return _downsamplingModeAction; }
+        OptionAction& getDownsamplingModeAction() { return _downsamplingModeAction; }
 
     protected:
         SettingsAction& _settingsOptions;
@@ -125,6 +158,14 @@ public:
         OptionAction    _smoothingTypeAction;
         OptionAction    _normalizationTypeAction;
         IntegralAction    _smoothingWindowAction;
+        IntegralAction    _polynomialOrderAction;
+        IntegralAction    _derivativeOrderAction;
+        DecimalAction     _quantileAction;
+        DecimalAction     _splineBandwidthAction;
+        DecimalAction     _xWindowWidthAction;
+        DecimalAction     _lowessSpanAction;
+        IntegralAction    _robustnessIterationsAction;
+        IntegralAction    _lowessGridSizeAction;
         StringAction    _chartTitleAction;
         ToggleAction _switchAxesAction;
         ColorMap1DAction        _pointDatasetDimensionColorMapAction;
@@ -133,6 +174,12 @@ public:
         OptionAction        _sortByAxisAction;
         ToggleAction        _showEnvelopeAction;
         ToggleAction        _showStatLineAction;
+        OptionAction        _statLineTypeAction;
+        OptionAction        _changePointCostAction;
+        DecimalAction       _changePointPenaltyAction;
+        OptionAction        _xAggregationAction;
+        DecimalAction       _xBinWidthAction;
+        OptionAction        _downsamplingModeAction;
     };
 
 public:
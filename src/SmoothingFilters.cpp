@@ -0,0 +1,57 @@
+#include "SmoothingFilters.h"
+
+QStringList smoothingFilterNames()
+{
+    QStringList names;
+    forEachSmoothingFilter([&names](auto filter) {
+        names << QString::fromLatin1(decltype(filter)::name.data(), static_cast<qsizetype>(decltype(filter)::name.size()));
+        });
+    return names;
+}
+
+std::optional<SmoothingType> smoothingTypeFromName(const QString& name)
+{
+    std::optional<SmoothingType> type;
+    forEachSmoothingFilter([&name, &type](auto filter) {
+        using Filter = decltype(filter);
+        if (!type && name == QLatin1String(Filter::name.data(), static_cast<qsizetype>(Filter::name.size())))
+            type = Filter::type;
+        });
+    return type;
+}
+
+bool smoothingFilterReads(SmoothingType type, SmoothingParameter parameter)
+{
+    bool reads = false;
+    visitSmoothingFilter(type, [parameter, &reads](auto filter) {
+        const auto& parameters = decltype(filter)::parameters;
+        reads = std::find(parameters.begin(), parameters.end(), parameter) != parameters.end();
+        });
+    return reads;
+}
+
+double smoothingCost(SmoothingType type, std::size_t n, const SmoothingParameters& parameters)
+{
+    double cost = static_cast<double>(n);
+    visitSmoothingFilter(type, [n, &parameters, &cost](auto filter) {
+        cost = decltype(filter)::cost(n, parameters);
+        });
+    return cost;
+}
+
+void applySmoothing(
+    const LineSeries& normalizedData,
+    SmoothingType type,
+    const SmoothingParameters& parameters,
+    LineSeries& smoothedData,
+    SmoothingWorkspace* workspace)
+{
+    SmoothingWorkspace localWorkspace;
+    SmoothingWorkspace& scratch = workspace ? *workspace : localWorkspace;
+    const bool applied = visitSmoothingFilter(type, [&](auto filter) {
+        decltype(filter)::apply(normalizedData, parameters, smoothedData, scratch);
+        });
+
+    if (!applied)
+        smoothedData = normalizedData;
+}
@@ -0,0 +1,250 @@
+#pragma once
+
+#include "LinePlotUtils.h"
+#include "Lowess.h"
+#include "SmoothingWorkspace.h"
+#include "XWindowSmoothing.h"
+
+#include <QString>
+#include <QStringList>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <tuple>
+
+/**
+ * Compile-time registry of the smoothing filters
+ *
+ * Every filter is a type declaring:
+ *  - type: its SmoothingType
+ *  - name: the text shown in the smoothing combo box, also the serialized setting
+ *  - parameters: the SmoothingParameters fields it reads
+ *  - cost(n, parameters): rough number of element operations for n points
+ *  - apply(data, parameters, smoothed, workspace): the kernel, writing into a caller-provided
+ *    series whose capacity is kept between runs. The moving average, Gaussian, running
+ *    quantile, X-window and LOWESS kernels keep their O(n) scratch (prefix sums, filter
+ *    passes, quantile heaps, X-sorted copies) in the workspace; the Savitzky-Golay
+ *    coefficients, FFT buffers, spline solver and LOWESS fit buffers are still per call
+ *
+ * The lookups below fold over SmoothingFilterList, so dispatching to a kernel is a
+ * chain of constant comparisons rather than a string or virtual lookup. A filter is
+ * added by declaring its type and listing it in SmoothingFilterList; the settings
+ * and the plugin pick it up from there.
+ */
+
+// SmoothingParameters fields a filter can read
+enum class SmoothingParameter {
+    WindowSize,
+    PolynomialOrder,
+    DerivativeOrder,
+    Quantile,
+    SplineBandwidth,
+    SampleCount,
+    XWindowWidth,
+    LowessSpan,
+    RobustnessIterations,
+    LowessGridSize
+};
+
+namespace smoothing_filters
+{
+    inline double logCost(double value) { return std::log2(std::max(value, 2.0)); }
+
+    struct None {
+        static constexpr SmoothingType type = SmoothingType::None;
+        static constexpr std::string_view name = "None";
+        static constexpr std::array<SmoothingParameter, 0> parameters{};
+        static double cost(std::size_t n, const SmoothingParameters&) { return static_cast<double>(n); }
+        static void apply(const LineSeries& data, const SmoothingParameters&, LineSeries& smoothed, SmoothingWorkspace&) { smoothed = data; }
+    };
+
+    struct MovingAverage {
+        static constexpr SmoothingType type = SmoothingType::MovingAverage;
+        static constexpr std::string_view name = "Moving Average";
+        static constexpr std::array parameters{ SmoothingParameter::WindowSize };
+        static double cost(std::size_t n, const SmoothingParameters&) { return 4.0 * n; }
+        static void apply(const LineSeries& data, const SmoothingParameters& p, LineSeries& smoothed, SmoothingWorkspace& workspace) { applyMovingAverage(data, p.windowSize, smoothed, &workspace); }
+    };
+
+    struct SavitzkyGolay {
+        static constexpr SmoothingType type = SmoothingType::SavitzkyGolay;
+        static constexpr std::string_view name = "Savitzky-Golay";
+        static constexpr std::array parameters{ SmoothingParameter::WindowSize, SmoothingParameter::PolynomialOrder, SmoothingParameter::DerivativeOrder };
+        // Direct FIR for short windows, FFT convolution for long ones
+        static double cost(std::size_t n, const SmoothingParameters& p) { return n * std::min<double>(p.windowSize, 8.0 * logCost(p.windowSize)); }
+        static void apply(const LineSeries& data, const SmoothingParameters& p, LineSeries& smoothed, SmoothingWorkspace&) { applySavitzkyGolay(data, p.windowSize, p.polynomialOrder, p.derivativeOrder, smoothed); }
+    };
+
+    struct Gaussian {
+        static constexpr SmoothingType type = SmoothingType::Gaussian;
+        static constexpr std::string_view name = "Gaussian";
+        static constexpr std::array parameters{ SmoothingParameter::WindowSize };
+        // Direct kernel for narrow windows, recursive filter otherwise
+        static double cost(std::size_t n, const SmoothingParameters& p) { return n * std::min(static_cast<double>(p.windowSize), 16.0); }
+        static void apply(const LineSeries& data, const SmoothingParameters& p, LineSeries& smoothed, SmoothingWorkspace& workspace) { applyGaussian(data, p.windowSize, smoothed, &workspace); }
+    };
+
+    struct ExponentialMovingAverage {
+        static constexpr SmoothingType type = SmoothingType::ExponentialMovingAverage;
+        static constexpr std::string_view name = "Exponential Moving Average";
+        static constexpr std::array<SmoothingParameter, 0> parameters{};
+        static double cost(std::size_t n, const SmoothingParameters&) { return 2.0 * n; }
+        static void apply(const LineSeries& data, const SmoothingParameters&, LineSeries& smoothed, SmoothingWorkspace&) { applyExponentialMovingAverage(data, smoothed); }
+    };
+
+    struct CubicSpline {
+        static constexpr SmoothingType type = SmoothingType::CubicSpline;
+        static constexpr std::string_view name = "Cubic Spline";
+        static constexpr std::array parameters{ SmoothingParameter::SplineBandwidth, SmoothingParameter::SampleCount };
+        static double cost(std::size_t n, const SmoothingParameters& p) { return 30.0 * n + 10.0 * std::max(p.sampleCount, 0); }
+        static void apply(const LineSeries& data, const SmoothingParameters& p, LineSeries& smoothed, SmoothingWorkspace&) { applyCubicSpline(data, p.splineBandwidth, p.sampleCount, smoothed); }
+    };
+
+    struct LinearInterpolation {
+        static constexpr SmoothingType type = SmoothingType::LinearInterpolation;
+        static constexpr std::string_view name = "Linear Interpolation";
+        static constexpr std::array parameters{ SmoothingParameter::WindowSize };
+        static double cost(std::size_t n, const SmoothingParameters&) { return 2.0 * n; }
+        static void apply(const LineSeries& data, const SmoothingParameters& p, LineSeries& smoothed, SmoothingWorkspace&) { applyLinearInterpolation(data, p.windowSize, smoothed); }
+    };
+
+    struct MinMaxSampling {
+        static constexpr SmoothingType type = SmoothingType::MinMaxSampling;
+        static constexpr std::string_view name = "Min-Max Sampling";
+        static constexpr std::array parameters{ SmoothingParameter::WindowSize };
+        static double cost(std::size_t n, const SmoothingParameters&) { return 2.0 * n; }
+        static void apply(const LineSeries& data, const SmoothingParameters& p, LineSeries& smoothed, SmoothingWorkspace&) { applyMinMaxSampling(data, p.windowSize, smoothed); }
+    };
+
+    struct RunningMedian {
+        static constexpr SmoothingType type = SmoothingType::RunningMedian;
+        static constexpr std::string_view name = "Running Median";
+        static constexpr std::array parameters{ SmoothingParameter::WindowSize };
+        static double cost(std::size_t n, const SmoothingParameters& p) { return 8.0 * n * logCost(p.windowSize); }
+        static void apply(const LineSeries& data, const SmoothingParameters& p, LineSeries& smoothed, SmoothingWorkspace& workspace) { applyRunningMedian(data, p.windowSize, smoothed, &workspace); }
+    };
+
+    struct RunningQuantile {
+        static constexpr SmoothingType type = SmoothingType::RunningQuantile;
+        static constexpr std::string_view name = "Running Quantile";
+        static constexpr std::array parameters{ SmoothingParameter::WindowSize, SmoothingParameter::Quantile };
+        static double cost(std::size_t n, const SmoothingParameters& p) { return 8.0 * n * logCost(p.windowSize); }
+        static void apply(const LineSeries& data, const SmoothingParameters& p, LineSeries& smoothed, SmoothingWorkspace& workspace) { applyRunningQuantile(data, p.windowSize, p.quantile, smoothed, &workspace); }
+    };
+
+    struct XWindowMean {
+        static constexpr SmoothingType type = SmoothingType::XWindowMean;
+        static constexpr std::string_view name = "X-Window Mean";
+        static constexpr std::array parameters{ SmoothingParameter::XWindowWidth };
+        static double cost(std::size_t n, const SmoothingParameters&) { return 4.0 * n; }
+        static void apply(const LineSeries& data, const SmoothingParameters& p, LineSeries& smoothed, SmoothingWorkspace& workspace) { applyXWindowMean(data, p.xWindowWidth, smoothed, &workspace); }
+    };
+
+    struct XWindowMedian {
+        static constexpr SmoothingType type = SmoothingType::XWindowMedian;
+        static constexpr std::string_view name = "X-Window Median";
+        static constexpr std::array parameters{ SmoothingParameter::XWindowWidth };
+        // The window population is unknown up front, assume it grows with the series
+        static double cost(std::size_t n, const SmoothingParameters&) { return 8.0 * n * logCost(static_cast<double>(n)); }
+        static void apply(const LineSeries& data, const SmoothingParameters& p, LineSeries& smoothed, SmoothingWorkspace& workspace) { applyXWindowMedian(data, p.xWindowWidth, smoothed, &workspace); }
+    };
+
+    struct XWindowMinimum {
+        static constexpr SmoothingType type = SmoothingType::XWindowMinimum;
+        static constexpr std::string_view name = "X-Window Minimum";
+        static constexpr std::array parameters{ SmoothingParameter::XWindowWidth };
+        static double cost(std::size_t n, const SmoothingParameters&) { return 4.0 * n; }
+        static void apply(const LineSeries& data, const SmoothingParameters& p, LineSeries& smoothed, SmoothingWorkspace& workspace) { applyXWindowMinimum(data, p.xWindowWidth, smoothed, &workspace); }
+    };
+
+    struct XWindowMaximum {
+        static constexpr SmoothingType type = SmoothingType::XWindowMaximum;
+        static constexpr std::string_view name = "X-Window Maximum";
+        static constexpr std::array parameters{ SmoothingParameter::XWindowWidth };
+        static double cost(std::size_t n, const SmoothingParameters&) { return 4.0 * n; }
+        static void apply(const LineSeries& data, const SmoothingParameters& p, LineSeries& smoothed, SmoothingWorkspace& workspace) { applyXWindowMaximum(data, p.xWindowWidth, smoothed, &workspace); }
+    };
+
+    struct XWindowGaussian {
+        static constexpr SmoothingType type = SmoothingType::XWindowGaussian;
+        static constexpr std::string_view name = "X-Window Gaussian";
+        static constexpr std::array parameters{ SmoothingParameter::XWindowWidth };
+        static double cost(std::size_t n, const SmoothingParameters&) { return 12.0 * n; }
+        static void apply(const LineSeries& data, const SmoothingParameters& p, LineSeries& smoothed, SmoothingWorkspace& workspace) { applyXWindowGaussian(data, p.xWindowWidth, smoothed, &workspace); }
+    };
+
+    struct Lowess {
+        static constexpr SmoothingType type = SmoothingType::Lowess;
+        static constexpr std::string_view name = "LOWESS";
+        static constexpr std::array parameters{ SmoothingParameter::LowessSpan, SmoothingParameter::RobustnessIterations, SmoothingParameter::LowessGridSize };
+        static double cost(std::size_t n, const SmoothingParameters& p)
+        {
+            const double evaluations = p.lowessGridSize >= 2 ? std::min<double>(p.lowessGridSize, n) : n;
+            const double neighbors = std::clamp<double>(p.lowessSpan * n, 2.0, std::max<double>(n, 2.0));
+            return 10.0 * evaluations * neighbors * (std::max(p.robustnessIterations, 0) + 1);
+        }
+        static void apply(const LineSeries& data, const SmoothingParameters& p, LineSeries& smoothed, SmoothingWorkspace& workspace)
+        {
+            applyLowess(data, p.lowessSpan, p.robustnessIterations, static_cast<std::size_t>(std::max(p.lowessGridSize, 0)), smoothed, &workspace);
+        }
+    };
+}
+
+// All filters, in the order the smoothing combo box lists them
+using SmoothingFilterList = std::tuple<
+    smoothing_filters::None,
+    smoothing_filters::MovingAverage,
+    smoothing_filters::SavitzkyGolay,
+    smoothing_filters::Gaussian,
+    smoothing_filters::ExponentialMovingAverage,
+    smoothing_filters::CubicSpline,
+    smoothing_filters::LinearInterpolation,
+    smoothing_filters::MinMaxSampling,
+    smoothing_filters::RunningMedian,
+    smoothing_filters::RunningQuantile,
+    smoothing_filters::XWindowMean,
+    smoothing_filters::XWindowMedian,
+    smoothing_filters::XWindowMinimum,
+    smoothing_filters::XWindowMaximum,
+    smoothing_filters::XWindowGaussian,
+    smoothing_filters::Lowess>;
+
+// Calls visitor(Filter{}) for every registered filter type, in list order
+template <typename Visitor>
+void forEachSmoothingFilter(Visitor&& visitor)
+{
+    std::apply([&visitor](auto... filters) { (visitor(filters), ...); }, SmoothingFilterList{});
+}
+
+// Calls visitor(Filter{}) for the filter of type and returns true, or false when no filter has that type
+template <typename Visitor>
+bool visitSmoothingFilter(SmoothingType type, Visitor&& visitor)
+{
+    return std::apply([type, &visitor](auto... filters) {
+        return ((decltype(filters)::type == type ? (visitor(filters), true) : false) || ...);
+        }, SmoothingFilterList{});
+}
+
+/** Names of all filters, in combo box order */
+QStringList smoothingFilterNames();
+
+/** Type of the filter called \p name */
+std::optional<SmoothingType> smoothingTypeFromName(const QString& name);
+
+/** Whether the filter of \p type reads \p parameter */
+bool smoothingFilterReads(SmoothingType type, SmoothingParameter parameter);
+
+/** Estimated element operations of smoothing \p n points */
+double smoothingCost(SmoothingType type, std::size_t n, const SmoothingParameters& parameters);
+
+/** Smooth \p normalizedData with the filter of \p type, an unknown type copies the data; \p workspace keeps the kernel scratch between calls when given */
+void applySmoothing(
+    const LineSeries& normalizedData,
+    SmoothingType type,
+    const SmoothingParameters& parameters,
+    LineSeries& smoothedData,
+    SmoothingWorkspace* workspace = nullptr);
@@ -0,0 +1,181 @@
+#include "SmoothingSpline.h"
+
+#include "RadixSort.h"
+
+#include <algorithm>
+#include <cmath>
+
+void SmoothingSpline::clear()
+{
+    _knots.clear();
+    _values.clear();
+    _curvatures.clear();
+}
+
+void SmoothingSpline::fit(const LineSeries& data, double bandwidth)
+{
+    clear();
+    const std::size_t n = data.size();
+    if (n == 0)
+        return;
+
+    const float* x = data.xData();
+    const float* y = data.yData();
+
+    // Visit the points in X order; the series is usually sorted by X already
+    SortPermutation order;
+    if (!std::is_sorted(x, x + n))
+        radixSortPermutation(x, n, order);
+    const auto at = [&order](std::size_t i) { return order.empty() ? i : static_cast<std::size_t>(order[i]); };
+
+    // Merge points with equal X into weighted knots holding their mean
+    std::vector<double> weights;
+    _knots.reserve(n);
+    _values.reserve(n);
+    weights.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const double xi = x[at(i)];
+        const double yi = y[at(i)];
+        if (!_knots.empty() && xi == _knots.back()) {
+            weights.back() += 1.0;
+            _values.back() += (yi - _values.back()) / weights.back();
+            continue;
+        }
+        _knots.push_back(xi);
+        _values.push_back(yi);
+        weights.push_back(1.0);
+    }
+
+    const std::size_t m = _knots.size();
+    _curvatures.assign(m, 0.0);
+    if (m < 3)
+        return;
+
+    // lambda has units of X^3; bandwidth b spacings h corresponds to lambda = b^4 h^3
+    const double spacing = (_knots.back() - _knots.front()) / static_cast<double>(n - 1);
+    const double lambda = bandwidth > 0.0 ? std::pow(bandwidth, 4.0) * std::pow(spacing, 3.0) : 0.0;
+
+    // Unknowns are the curvatures of interior knots 1 .. m - 2, stored at k - 1
+    const std::size_t count = m - 2;
+    const auto h = [this](std::size_t i) { return _knots[i + 1] - _knots[i]; };
+    const auto d = [&weights, lambda](std::size_t i) { return lambda / weights[i]; };
+
+    // Bands of the system matrix: diagonal, first and second superdiagonal
+    std::vector<double> diagonal(count), upper1(count, 0.0), upper2(count, 0.0), rhs(count);
+    for (std::size_t k = 1; k <= m - 2; ++k) {
+        const double hp = h(k - 1), hk = h(k);
+        const double ip = 1.0 / hp, ik = 1.0 / hk;
+
+        rhs[k - 1] = (_values[k + 1] - _values[k]) * ik - (_values[k] - _values[k - 1]) * ip;
+        diagonal[k - 1] = (hp + hk) / 3.0 + d(k - 1) * ip * ip + d(k) * (ip + ik) * (ip + ik) + d(k + 1) * ik * ik;
+        if (k + 1 <= m - 2) {
+            const double in = 1.0 / h(k + 1);
+            upper1[k - 1] = hk / 6.0 - d(k) * (ip + ik) * ik - d(k + 1) * ik * (ik + in);
+        }
+        if (k + 2 <= m - 2)
+            upper2[k - 1] = d(k + 1) * ik / h(k + 1);
+    }
+
+    // LDL^T in place: diagonal becomes D, the superdiagonals the columns of L
+    for (std::size_t i = 0; i < count; ++i) {
+        if (i >= 1)
+            diagonal[i] -= upper1[i - 1] * upper1[i - 1] * diagonal[i - 1];
+        if (i >= 2)
+            diagonal[i] -= upper2[i - 2] * upper2[i - 2] * diagonal[i - 2];
+
+        if (i + 1 < count) {
+            if (i >= 1)
+                upper1[i] -= upper1[i - 1] * upper2[i - 1] * diagonal[i - 1];
+            upper1[i] /= diagonal[i];
+        }
+        if (i + 2 < count)
+            upper2[i] /= diagonal[i];
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+        if (i >= 1)
+            rhs[i] -= upper1[i - 1] * rhs[i - 1];
+        if (i >= 2)
+            rhs[i] -= upper2[i - 2] * rhs[i - 2];
+    }
+    for (std::size_t i = 0; i < count; ++i)
+        rhs[i] /= diagonal[i];
+    for (std::size_t i = count; i-- > 0;) {
+        if (i + 1 < count)
+            rhs[i] -= upper1[i] * rhs[i + 1];
+        if (i + 2 < count)
+            rhs[i] -= upper2[i] * rhs[i + 2];
+    }
+
+    std::copy(rhs.begin(), rhs.end(), _curvatures.begin() + 1);
+
+    // Fitted values g = y - lambda W^-1 Q gamma
+    if (lambda > 0.0) {
+        for (std::size_t i = 0; i < m; ++i) {
+            double q = 0.0;
+            if (i > 0)
+                q += (_curvatures[i - 1] - _curvatures[i]) / h(i - 1);
+            if (i + 1 < m)
+                q += (_curvatures[i + 1] - _curvatures[i]) / h(i);
+            _values[i] -= d(i) * q;
+        }
+    }
+}
+
+double SmoothingSpline::evaluateInterval(std::size_t i, double x) const
+{
+    const double width = _knots[i + 1] - _knots[i];
+    const double a = (_knots[i + 1] - x) / width;
+    const double b = 1.0 - a;
+    return a * _values[i] + b * _values[i + 1]
+        + ((a * a * a - a) * _curvatures[i] + (b * b * b - b) * _curvatures[i + 1]) * width * width / 6.0;
+}
+
+double SmoothingSpline::evaluate(double x) const
+{
+    const std::size_t m = _knots.size();
+    if (m == 0)
+        return 0.0;
+    if (m == 1)
+        return _values[0];
+
+    // The natural end conditions make the curve continue along the end tangents
+    if (x <= _knots.front()) {
+        const double slope = (_values[1] - _values[0]) / (_knots[1] - _knots[0]) - (_knots[1] - _knots[0]) * _curvatures[1] / 6.0;
+        return _values[0] + slope * (x - _knots[0]);
+    }
+    if (x >= _knots.back()) {
+        const double width = _knots[m - 1] - _knots[m - 2];
+        const double slope = (_values[m - 1] - _values[m - 2]) / width + width * _curvatures[m - 2] / 6.0;
+        return _values[m - 1] + slope * (x - _knots[m - 1]);
+    }
+
+    const auto interval = static_cast<std::size_t>(std::upper_bound(_knots.begin(), _knots.end(), x) - _knots.begin()) - 1;
+    return evaluateInterval(interval, x);
+}
+
+void SmoothingSpline::sample(std::size_t count, LineSeries& out) const
+{
+    const std::size_t m = _knots.size();
+    if (count < 2 || m < 2) {
+        out.resize(m);
+        for (std::size_t i = 0; i < m; ++i) {
+            out.xData()[i] = static_cast<float>(_knots[i]);
+            out.yData()[i] = static_cast<float>(_values[i]);
+        }
+        return;
+    }
+
+    // Sample positions ascend, so the interval only ever moves forward
+    out.resize(count);
+    const double first = _knots.front();
+    const double step = (_knots.back() - first) / static_cast<double>(count - 1);
+    std::size_t interval = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const double x = i + 1 == count ? _knots.back() : first + step * static_cast<double>(i);
+        while (interval + 2 < m && _knots[interval + 1] <= x)
+            ++interval;
+        out.xData()[i] = static_cast<float>(x);
+        out.yData()[i] = static_cast<float>(evaluateInterval(interval, x));
+    }
+}
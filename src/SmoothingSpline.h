@@ -0,0 +1,52 @@
+#pragma once
+
+#include "../libs/LineChartLib/LineSeries.h"
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Natural cubic smoothing spline in Reinsch form
+ *
+ * fit() minimizes sum_i w_i (y_i - g(x_i))^2 + lambda * integral g''(x)^2 dx over
+ * natural cubic splines g with knots at the distinct X values; points sharing an
+ * X are merged into one knot weighted by their count. The interior second
+ * derivatives solve the symmetric pentadiagonal system (R + lambda Q^T W^-1 Q),
+ * which is factored by a banded LDL^T sweep in O(n). Without smoothing the
+ * system is the tridiagonal one of the interpolating spline and the sweep is
+ * the Thomas algorithm.
+ *
+ * The fitted curve is stored as values and second derivatives at the knots, so
+ * it can be sampled at any resolution afterwards without refitting.
+ */
+class SmoothingSpline
+{
+public:
+    /**
+     * Fit the spline to \p data
+     * @param data Points to fit, in any X order
+     * @param bandwidth Smoothing scale in average point spacings, 0 interpolates
+     */
+    void fit(const LineSeries& data, double bandwidth);
+
+    void clear();
+    bool isEmpty() const { return _knots.empty(); }
+
+    /** Value at \p x, linear beyond the outer knots */
+    double evaluate(double x) const;
+
+    /**
+     * Evaluate the spline on \p count evenly spaced X positions spanning the knots,
+     * or at the knots themselves when \p count is less than 2
+     */
+    void sample(std::size_t count, LineSeries& out) const;
+
+private:
+    /** Value at \p x on the interval between knot \p i and \p i + 1 */
+    double evaluateInterval(std::size_t i, double x) const;
+
+private:
+    std::vector<double>     _knots;         // Distinct X, ascending
+    std::vector<double>     _values;        // Fitted value at each knot
+    std::vector<double>     _curvatures;    // Second derivative at each knot, zero at both ends
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "RollingQuantile.h"
+#include "../libs/LineChartLib/LineSeries.h"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Scratch buffers of the smoothing kernels, reused between calls
+ *
+ * A kernel handed a workspace resizes the buffers it needs instead of allocating
+ * its own, so smoothing many columns, or the same series run after run, only
+ * allocates when a buffer has to grow. A workspace must not be shared by two
+ * calls at once.
+ */
+struct SmoothingWorkspace
+{
+    std::vector<double>         sums;       // Prefix sums and recursive filter passes
+    std::vector<float>          values;     // Intermediate Y values
+    std::vector<std::uint32_t>  indices;    // Window handles and candidate queues
+    RollingQuantile             quantile;   // Running quantile engine, cleared before use
+    LineSeries                  sorted;     // X-sorted copy of the input
+};
@@ -0,0 +1,583 @@
+#include "TrendLine.h"
+
+#include "ParallelUtils.h"
+#include "RadixSort.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // Two-sided 95% quantile of the standard normal distribution
+    constexpr double kNormalQuantile95 = 1.959963984540054;
+
+    // Two-sided 95% quantile of Student's t distribution
+    double studentQuantile95(double degreesOfFreedom)
+    {
+        static constexpr double table[] = { 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228 };
+        if (degreesOfFreedom < 1.0)
+            return std::numeric_limits<double>::infinity();
+        if (degreesOfFreedom <= 10.0)
+            return table[static_cast<int>(degreesOfFreedom) - 1];
+
+        // Cornish-Fisher expansion around the normal quantile, within 0.002 from 11 degrees of freedom on
+        const double z = kNormalQuantile95;
+        const double z3 = z * z * z;
+        const double z5 = z3 * z * z;
+        return z + (z3 + z) / (4.0 * degreesOfFreedom) + (5.0 * z5 + 16.0 * z3 + 3.0 * z) / (96.0 * degreesOfFreedom * degreesOfFreedom);
+    }
+
+    // Runs shorter than this are sorted by insertion before merging
+    constexpr std::size_t kInsertionRun = 32;
+
+    // Larger series are fitted on a stratified subsample of this many points
+    constexpr std::size_t kTheilSenMaxPoints = 1 << 19;
+
+    /**
+     * Merge two sorted runs into out and count the pairs (left, right) with !less(left, right)
+     *
+     * Every right item that is taken before some left items is reported with the
+     * block of those left items through visit(task, item, block, blockSize).
+     */
+    template <typename Item, typename Less, typename Visit>
+    std::uint64_t mergeRuns(const Item* left, std::size_t leftCount, const Item* right, std::size_t rightCount, Item* out, const Less& less, Visit& visit, std::size_t task)
+    {
+        std::uint64_t inversions = 0;
+        std::size_t a = 0, b = 0;
+        while (a < leftCount && b < rightCount) {
+            if (less(left[a], right[b])) {
+                *out++ = left[a++];
+            }
+            else {
+                visit(task, right[b], left + a, leftCount - a);
+                inversions += leftCount - a;
+                *out++ = right[b++];
+            }
+        }
+        out = std::copy(left + a, left + leftCount, out);
+        std::copy(right + b, right + rightCount, out);
+        return inversions;
+    }
+
+    // Sequential merge sort of [begin, end), counting inversions as mergeRuns() does; stops early on cancellation
+    template <typename Item, typename Less, typename Visit>
+    std::uint64_t sortRange(Item* items, Item* buffer, std::size_t begin, std::size_t end, const Less& less, Visit& visit, std::size_t task, const CancellationToken& cancellation)
+    {
+        std::uint64_t inversions = 0;
+        for (std::size_t run = begin; run < end; run += kInsertionRun) {
+            const std::size_t runEnd = std::min(run + kInsertionRun, end);
+            for (std::size_t i = run + 1; i < runEnd; ++i) {
+                const Item item = items[i];
+                std::size_t j = i;
+                while (j > run && !less(items[j - 1], item))
+                    --j;
+                if (j == i)
+                    continue;
+                visit(task, item, items + j, i - j);
+                inversions += i - j;
+                std::copy_backward(items + j, items + i, items + i + 1);
+                items[j] = item;
+            }
+        }
+
+        Item* source = items;
+        Item* target = buffer;
+        for (std::size_t width = kInsertionRun; width < end - begin; width *= 2) {
+            if (cancellation.isCancelled())
+                return inversions;
+            for (std::size_t left = begin; left < end; left += 2 * width) {
+                const std::size_t middle = std::min(left + width, end);
+                const std::size_t right = std::min(left + 2 * width, end);
+                inversions += mergeRuns(source + left, middle - left, source + middle, right - middle, target + left, less, visit, task);
+            }
+            std::swap(source, target);
+        }
+        if (source != items)
+            std::copy(source + begin, source + end, items + begin);
+        return inversions;
+    }
+
+    // Upper bound on the task indices sortCountingInversions() hands to visit
+    std::size_t mergeTaskCount(std::size_t count)
+    {
+        return 2 * parallelChunkCount(count, 1 << 15);
+    }
+
+    /**
+     * Sort items with a parallel merge sort and return the number of pairs i < j with !less(items[i], items[j])
+     *
+     * Chunks are sorted concurrently and then merged pairwise, level by level.
+     * visit is called concurrently, but never twice at once with the same task index.
+     * Once \p cancellation fires the sort stops between merge passes, leaving items
+     * and the count meaningless.
+     */
+    template <typename Item, typename Less, typename Visit>
+    std::uint64_t sortCountingInversions(std::vector<Item>& items, std::vector<Item>& buffer, const Less& less, Visit visit, const CancellationToken& cancellation)
+    {
+        const std::size_t count = items.size();
+        buffer.resize(count);
+        const std::size_t numChunks = parallelChunkCount(count, 1 << 15);
+
+        std::vector<std::uint64_t> inversions(2 * numChunks, 0);
+        parallelForChunks(count, numChunks, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+            inversions[chunk] = sortRange(items.data(), buffer.data(), begin, end, less, visit, chunk, cancellation);
+            });
+
+        std::vector<std::size_t> bounds(numChunks + 1);
+        for (std::size_t chunk = 0; chunk <= numChunks; ++chunk)
+            bounds[chunk] = parallelChunkBegin(count, numChunks, chunk);
+
+        std::size_t task = numChunks;
+        while (bounds.size() > 2) {
+            if (cancellation.isCancelled())
+                return 0;
+            const std::size_t numRuns = bounds.size() - 1;
+            const std::size_t numPairs = numRuns / 2;
+            parallelForChunks(numPairs, numPairs, [&](std::size_t pair, std::size_t, std::size_t) {
+                const std::size_t left = bounds[2 * pair];
+                const std::size_t middle = bounds[2 * pair + 1];
+                const std::size_t right = bounds[2 * pair + 2];
+                inversions[task + pair] = mergeRuns(items.data() + left, middle - left, items.data() + middle, right - middle, buffer.data() + left, less, visit, task + pair);
+                std::copy(buffer.data() + left, buffer.data() + right, items.data() + left);
+                });
+            task += numPairs;
+
+            std::vector<std::size_t> merged;
+            for (std::size_t run = 0; run < numRuns; run += 2)
+                merged.push_back(bounds[run]);
+            merged.push_back(count);
+            bounds.swap(merged);
+        }
+
+        std::uint64_t total = 0;
+        for (const std::uint64_t value : inversions)
+            total += value;
+        return total;
+    }
+
+    struct OrderedPoint
+    {
+        double          key;
+        std::uint32_t   index;
+    };
+
+    /**
+     * Selects slopes by rank among the pairs of points with different X
+     *
+     * Points are in ascending X order and, within equal X, in ascending Y order.
+     * Every count is kept as a probe; the interval of a rank is bounded by the
+     * nearest probes on either side.
+     */
+    class SlopeSelector
+    {
+    public:
+        SlopeSelector(const std::vector<float>& x, const std::vector<float>& y, double xCenter, std::uint64_t duplicatePairs, const CancellationToken& cancellation) :
+            _x(x),
+            _y(y),
+            _xCenter(xCenter),
+            _duplicatePairs(duplicatePairs),
+            _cancellation(cancellation)
+        {
+        }
+
+        /** Add a slope t with known count(t) */
+        void addProbe(double t, std::uint64_t count)
+        {
+            _probes.push_back({ t, count });
+        }
+
+        /** Number of slopes <= t, meaningless and not kept as a probe once cancelled */
+        std::uint64_t countAtMost(double t)
+        {
+            if (_cancellation.isCancelled())
+                return 0;
+            const std::size_t n = _x.size();
+            _keys.resize(n);
+            parallelForChunks(n, parallelChunkCount(n, 1 << 16), [&](std::size_t, std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i)
+                    _keys[i] = residual(i, t);
+                });
+
+            // The pairs i < j with u_i >= u_j are the slopes up to t, plus the duplicate points
+            const auto noVisit = [](std::size_t, double, const double*, std::size_t) {};
+            const std::uint64_t count = sortCountingInversions(_keys, _keyBuffer, std::less<double>(), noVisit, _cancellation) - _duplicatePairs;
+            if (_cancellation.isCancelled())
+                return 0;
+            addProbe(t, count);
+            return count;
+        }
+
+        /**
+         * Slopes of the 0-based \p ranks, NaN for those not found before cancellation
+         *
+         * A nonzero tolerance lets the search stop at a slope whose rank is within
+         * about that many ranks of the target. Ranks that share an interval share
+         * the sample of a round, so ranks close to each other cost little more
+         * than one.
+         */
+        std::vector<double> select(const std::vector<std::uint64_t>& ranks, const std::vector<std::uint64_t>& tolerances)
+        {
+            const std::uint64_t n = _x.size();
+            const std::uint64_t enumerationLimit = std::max<std::uint64_t>(4 * n, 1 << 20);
+            const double sampleSize = static_cast<double>(std::max<std::uint64_t>(n, 1 << 16));
+
+            std::vector<double> slopes(ranks.size(), std::numeric_limits<double>::quiet_NaN());
+            std::vector<bool> done(ranks.size(), false);
+            std::vector<double> sample;
+            for (int round = 0; ; ++round) {
+                const auto next = std::find(done.begin(), done.end(), false);
+                if (next == done.end() || _cancellation.isCancelled())
+                    return slopes;
+
+                const Interval interval = bracket(ranks[next - done.begin()]);
+                const std::uint64_t inside = interval.countHi - interval.countLo;
+                const bool enumerate = inside <= enumerationLimit || round >= 32;
+                collectSlopes(interval, enumerate ? 1.0 : sampleSize / static_cast<double>(inside), round, sample);
+                if (_cancellation.isCancelled())
+                    return slopes;
+
+                std::vector<std::size_t> group;
+                for (std::size_t i = 0; i < ranks.size(); ++i) {
+                    if (!done[i] && bracket(ranks[i]) == interval)
+                        group.push_back(i);
+                }
+
+                if (sample.empty()) {
+                    for (const std::size_t i : group) {
+                        slopes[i] = interval.hi;
+                        done[i] = enumerate;
+                    }
+                    continue;
+                }
+
+                // Slope rank - countLo of the interval is expected at this position of the sample
+                const double size = static_cast<double>(sample.size());
+                const double spread = 3.0 * std::sqrt(size) + 1.0;
+                const auto position = [&](std::uint64_t rank, double offset) {
+                    const double expected = (static_cast<double>(rank - interval.countLo) + 0.5) / static_cast<double>(inside) * size;
+                    return static_cast<std::size_t>(std::clamp(expected + offset, 0.0, size - 1.0));
+                    };
+                const auto sampleAt = [&sample](std::size_t position) {
+                    std::nth_element(sample.begin(), sample.begin() + position, sample.end());
+                    return sample[position];
+                    };
+
+                for (const std::size_t i : group) {
+                    if (enumerate) {
+                        slopes[i] = sampleAt(static_cast<std::size_t>(std::min<std::uint64_t>(ranks[i] - interval.countLo, sample.size() - 1)));
+                        done[i] = true;
+                    }
+                    else if (tolerances[i] > 0 && static_cast<double>(inside) * spread / size <= static_cast<double>(tolerances[i])) {
+                        slopes[i] = sampleAt(position(ranks[i], 0.0));
+                        done[i] = true;
+                    }
+                }
+                if (enumerate)
+                    continue;
+
+                // Sample slopes a few standard deviations either side of the expected position bracket the target
+                for (const std::size_t i : group) {
+                    if (done[i] || bracket(ranks[i]) != interval)
+                        continue;
+
+                    const std::size_t lower = position(ranks[i], -spread);
+                    const std::size_t upper = position(ranks[i], spread);
+                    for (const double t : { lower > 0 ? sampleAt(lower) : interval.lo, upper + 1 < sample.size() ? sampleAt(upper) : interval.hi }) {
+                        if (t > interval.lo && t < interval.hi)
+                            countAtMost(t);
+                    }
+
+                    // No progress means many slopes equal hi, check whether the target is one of them
+                    if (bracket(ranks[i]) == interval && countAtMost(std::nextafter(interval.hi, -std::numeric_limits<double>::infinity())) <= ranks[i]) {
+                        slopes[i] = interval.hi;
+                        done[i] = true;
+                    }
+                }
+            }
+        }
+
+    private:
+        struct Probe
+        {
+            double          t;
+            std::uint64_t   count;
+        };
+
+        // Slopes in (lo, hi], countLo of all slopes are <= lo and countHi <= hi
+        struct Interval
+        {
+            double          lo;
+            double          hi;
+            std::uint64_t   countLo;
+            std::uint64_t   countHi;
+
+            bool operator==(const Interval& other) const { return lo == other.lo && hi == other.hi; }
+        };
+
+        // Tightest interval around the slope of rank
+        Interval bracket(std::uint64_t rank) const
+        {
+            Interval interval{ -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(), 0, 0 };
+            for (const auto& probe : _probes) {
+                if (probe.count <= rank && probe.t >= interval.lo) {
+                    interval.lo = probe.t;
+                    interval.countLo = probe.count;
+                }
+                if (probe.count > rank && probe.t <= interval.hi) {
+                    interval.hi = probe.t;
+                    interval.countHi = probe.count;
+                }
+            }
+            return interval;
+        }
+
+        // Intercept of the dual line of point i at slope t, y - t x, with X centered for precision
+        double residual(std::size_t i, double t) const
+        {
+            return static_cast<double>(_y[i]) - t * (static_cast<double>(_x[i]) - _xCenter);
+        }
+
+        /**
+         * Bernoulli sample with probability \p probability of the slopes in the interval
+         *
+         * Those are exactly the pairs that swap between the order at lo and the
+         * order at hi. The points are sorted at lo, ties broken at hi, and then
+         * merge sorted at hi; every inverted block the merge reports is sampled
+         * with geometric skips. Below all slopes the order at lo is the X order.
+         * The sample is left empty once cancelled.
+         */
+        void collectSlopes(const Interval& interval, double probability, int round, std::vector<double>& sample)
+        {
+            sample.clear();
+            if (_cancellation.isCancelled())
+                return;
+
+            const double lo = interval.lo;
+            const double hi = interval.hi;
+            const std::size_t n = _x.size();
+            _points.resize(n);
+            parallelForChunks(n, parallelChunkCount(n, 1 << 16), [&](std::size_t, std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i)
+                    _points[i] = { residual(i, lo), static_cast<std::uint32_t>(i) };
+                });
+
+            if (interval.countLo > 0) {
+                const auto noVisit = [](std::size_t, const OrderedPoint&, const OrderedPoint*, std::size_t) {};
+                const auto lessAtLo = [this, hi](const OrderedPoint& a, const OrderedPoint& b) {
+                    return a.key < b.key || (a.key == b.key && residual(a.index, hi) < residual(b.index, hi));
+                    };
+                sortCountingInversions(_points, _pointBuffer, lessAtLo, noVisit, _cancellation);
+                if (_cancellation.isCancelled())
+                    return;
+            }
+
+            parallelForChunks(n, parallelChunkCount(n, 1 << 16), [&](std::size_t, std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i)
+                    _points[i].key = residual(_points[i].index, hi);
+                });
+
+            struct TaskSample
+            {
+                std::mt19937_64     random;
+                std::uint64_t       skip = 0;
+                std::vector<double> slopes;
+            };
+            const std::size_t numTasks = mergeTaskCount(n);
+            std::vector<TaskSample> tasks(numTasks);
+            const bool all = probability >= 1.0;
+            const double logComplement = all ? 0.0 : std::log1p(-probability);
+            for (std::size_t task = 0; task < numTasks; ++task)
+                tasks[task].random.seed(0x5eed0000u + 1000u * static_cast<unsigned>(round) + static_cast<unsigned>(task));
+
+            const auto nextSkip = [all, logComplement](TaskSample& task) -> std::uint64_t {
+                if (all)
+                    return 0;
+                const double uniform = 1.0 - std::generate_canonical<double, 53>(task.random);
+                return static_cast<std::uint64_t>(std::min(std::log(uniform) / logComplement, 1e18));
+                };
+
+            for (auto& task : tasks)
+                task.skip = nextSkip(task);
+
+            const auto sampleBlock = [&](std::size_t taskIndex, const OrderedPoint& item, const OrderedPoint* block, std::size_t blockSize) {
+                TaskSample& task = tasks[taskIndex];
+                while (task.skip < blockSize) {
+                    const std::uint32_t a = block[task.skip].index;
+                    const std::uint32_t b = item.index;
+                    const double dx = static_cast<double>(_x[b]) - static_cast<double>(_x[a]);
+                    if (dx != 0.0)
+                        task.slopes.push_back((static_cast<double>(_y[b]) - static_cast<double>(_y[a])) / dx);
+                    task.skip += 1 + nextSkip(task);
+                }
+                task.skip -= blockSize;
+                };
+            const auto lessAtHi = [](const OrderedPoint& a, const OrderedPoint& b) { return a.key < b.key; };
+            sortCountingInversions(_points, _pointBuffer, lessAtHi, sampleBlock, _cancellation);
+            if (_cancellation.isCancelled())
+                return;
+
+            for (const auto& task : tasks)
+                sample.insert(sample.end(), task.slopes.begin(), task.slopes.end());
+        }
+
+        const std::vector<float>&   _x;
+        const std::vector<float>&   _y;
+        double                      _xCenter;
+        std::uint64_t               _duplicatePairs;
+        const CancellationToken&    _cancellation;
+        std::vector<Probe>          _probes;
+        std::vector<double>         _keys, _keyBuffer;
+        std::vector<OrderedPoint>   _points, _pointBuffer;
+    };
+}
+
+TrendLine fitLeastSquares(const SeriesStatistics& statistics)
+{
+    TrendLine line;
+    const std::size_t n = statistics.size();
+    if (n < 2 || !(statistics.x.m2 > 0.0))
+        return line;
+
+    const double sxx = statistics.x.m2;
+    line.valid = true;
+    line.count = n;
+    line.slope = statistics.coMoment / sxx;
+    line.intercept = statistics.y.mean - line.slope * statistics.x.mean;
+    line.pivotX = statistics.x.mean;
+    line.pivotY = statistics.y.mean;
+
+    double slopeHalfWidth = 0.0;
+    double interceptHalfWidth = 0.0;
+    if (n > 2) {
+        // Residual variance from the sums of squares, the regression removes slope * Sxy of Syy
+        const double count = static_cast<double>(n);
+        const double variance = std::max(0.0, statistics.y.m2 - line.slope * statistics.coMoment) / (count - 2.0);
+        const double t = studentQuantile95(count - 2.0);
+        slopeHalfWidth = t * std::sqrt(variance / sxx);
+        interceptHalfWidth = t * std::sqrt(variance * (1.0 / count + statistics.x.mean * statistics.x.mean / sxx));
+    }
+    line.slopeLower = line.slope - slopeHalfWidth;
+    line.slopeUpper = line.slope + slopeHalfWidth;
+    line.interceptLower = line.intercept - interceptHalfWidth;
+    line.interceptUpper = line.intercept + interceptHalfWidth;
+    return line;
+}
+
+TrendLine fitTheilSen(const LineSeries& data, const CancellationToken& cancellation)
+{
+    TrendLine line;
+    const std::size_t size = data.size();
+    if (size < 2 || size > std::numeric_limits<std::uint32_t>::max())
+        return line;
+
+    // Large series are fitted on one random point from each of kTheilSenMaxPoints runs of the
+    // series, which bounds the cost; Sen's interval then reflects the sample size. The series
+    // usually comes in X order, so the runs stratify the sample by X
+    LineSeries subsample;
+    if (size > kTheilSenMaxPoints) {
+        subsample.resize(kTheilSenMaxPoints);
+        std::mt19937_64 random(0x5eed5eedu);
+        for (std::size_t k = 0; k < kTheilSenMaxPoints; ++k) {
+            const std::size_t begin = parallelChunkBegin(size, kTheilSenMaxPoints, k);
+            const std::size_t end = parallelChunkBegin(size, kTheilSenMaxPoints, k + 1);
+            const std::size_t i = begin + static_cast<std::size_t>(random() % (end - begin));
+            subsample.xData()[k] = data.x(i);
+            subsample.yData()[k] = data.y(i);
+        }
+    }
+    const LineSeries& fitted = size > kTheilSenMaxPoints ? subsample : data;
+
+    LineSeries sorted;
+    const LineSeries& byX = sortSeriesByX(fitted, sorted) ? sorted : fitted;
+    const std::size_t n = byX.size();
+    std::vector<float> x(byX.xData(), byX.xData() + n);
+    std::vector<float> y(byX.yData(), byX.yData() + n);
+
+    // Order equal X by Y, count the pairs without a slope and find the slope range,
+    // which adjacent X values attain since any other slope averages slopes in between
+    std::uint64_t equalXPairs = 0;
+    std::uint64_t duplicatePairs = 0;
+    double minSlope = std::numeric_limits<double>::infinity();
+    double maxSlope = -std::numeric_limits<double>::infinity();
+    std::size_t previous = n;
+    for (std::size_t begin = 0; begin < n; ) {
+        std::size_t end = begin + 1;
+        while (end < n && x[end] == x[begin])
+            ++end;
+        std::sort(y.begin() + begin, y.begin() + end);
+
+        const std::uint64_t run = end - begin;
+        equalXPairs += run * (run - 1) / 2;
+        for (std::size_t i = begin; i < end; ) {
+            std::size_t j = i + 1;
+            while (j < end && y[j] == y[i])
+                ++j;
+            duplicatePairs += static_cast<std::uint64_t>(j - i) * (j - i - 1) / 2;
+            i = j;
+        }
+
+        if (previous < n) {
+            const double dx = static_cast<double>(x[begin]) - static_cast<double>(x[previous]);
+            minSlope = std::min(minSlope, (static_cast<double>(y[begin]) - static_cast<double>(y[begin - 1])) / dx);
+            maxSlope = std::max(maxSlope, (static_cast<double>(y[end - 1]) - static_cast<double>(y[previous])) / dx);
+        }
+        previous = begin;
+        begin = end;
+    }
+
+    const std::uint64_t pairs = static_cast<std::uint64_t>(n) * (n - 1) / 2 - equalXPairs;
+    if (pairs == 0)
+        return line;
+
+    // Start just outside the slope range, where the counts are known
+    const double margin = std::max({ 1e-6 * (maxSlope - minSlope), 1e-9 * std::max(std::abs(minSlope), std::abs(maxSlope)), std::numeric_limits<double>::min() });
+    const double pivotX = static_cast<double>(x[(n - 1) / 2]);
+    SlopeSelector selector(x, y, pivotX, duplicatePairs, cancellation);
+    selector.addProbe(minSlope - margin, 0);
+    selector.addProbe(maxSlope + margin, pairs);
+
+    // Sen's interval from the normal approximation of Kendall's statistic. Ranks need not be
+    // exact far below its width: the median is selected to 0.5% of the half width, the bounds to 2%
+    const double count = static_cast<double>(n);
+    const double halfWidth = kNormalQuantile95 * std::sqrt(count * (count - 1.0) * (2.0 * count + 5.0) / 18.0);
+    const double total = static_cast<double>(pairs);
+    const auto boundRank = [total](double rank) {
+        return static_cast<std::uint64_t>(std::clamp(rank, 0.0, total - 1.0));
+        };
+    const std::vector<double> slopes = selector.select(
+        { (pairs - 1) / 2, boundRank(std::floor((total - halfWidth) / 2.0)), boundRank(std::ceil((total + halfWidth) / 2.0)) },
+        { static_cast<std::uint64_t>(halfWidth / 200.0), static_cast<std::uint64_t>(halfWidth / 50.0), static_cast<std::uint64_t>(halfWidth / 50.0) });
+    const double slope = slopes[0];
+    const double slopeLower = slopes[1];
+    const double slopeUpper = slopes[2];
+    if (cancellation.isCancelled() || std::isnan(slope) || std::isnan(slopeLower) || std::isnan(slopeUpper))
+        return line;
+
+    // The intercept is cheap enough to take over all points
+    std::vector<double> intercepts(size);
+    parallelForChunks(size, parallelChunkCount(size, 1 << 16), [&](std::size_t, std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i)
+            intercepts[i] = static_cast<double>(data.y(i)) - slope * static_cast<double>(data.x(i));
+        });
+    const auto median = intercepts.begin() + (size - 1) / 2;
+    std::nth_element(intercepts.begin(), median, intercepts.end());
+
+    line.valid = true;
+    line.count = size;
+    line.slope = slope;
+    line.intercept = *median;
+    line.slopeLower = std::min(slopeLower, slope);
+    line.slopeUpper = std::max(slopeUpper, slope);
+    line.pivotX = pivotX;
+    line.pivotY = line.valueAt(pivotX);
+    const double interceptAtLower = line.pivotY - line.slopeLower * pivotX;
+    const double interceptAtUpper = line.pivotY - line.slopeUpper * pivotX;
+    line.interceptLower = std::min(interceptAtLower, interceptAtUpper);
+    line.interceptUpper = std::max(interceptAtLower, interceptAtUpper);
+    return line;
+}
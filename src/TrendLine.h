@@ -0,0 +1,66 @@
+#pragma once
+
+#include "CancellationToken.h"
+#include "SeriesStatistics.h"
+#include "../libs/LineChartLib/LineSeries.h"
+
+#include <cstddef>
+
+/**
+ * Straight line fitted through a series, with 95% confidence intervals
+ *
+ * The lines with the lower and upper slope bound both pass through the pivot,
+ * the point the fit is most certain about, so together they bound a fan
+ * around the fitted line.
+ */
+struct TrendLine
+{
+    bool        valid = false;
+    std::size_t count = 0;
+    double      slope = 0.0;
+    double      intercept = 0.0;
+    double      slopeLower = 0.0;
+    double      slopeUpper = 0.0;
+    double      interceptLower = 0.0;
+    double      interceptUpper = 0.0;
+    double      pivotX = 0.0;
+    double      pivotY = 0.0;
+
+    double valueAt(double x) const { return intercept + slope * x; }
+};
+
+/**
+ * Ordinary least squares fit from the statistics of a series
+ *
+ * Slope and intercept follow from the means, the sums of squared deviations and
+ * the co-moment that computeSeriesStatistics() gathers in its single pass, so
+ * no further pass over the points is needed. The intervals are the usual
+ * t-intervals of the normal error model; the pivot is the centroid.
+ */
+TrendLine fitLeastSquares(const SeriesStatistics& statistics);
+
+/**
+ * Theil-Sen fit: the median of the slopes between all pairs of points with different X
+ *
+ * The median is found by randomized slope selection instead of enumerating the
+ * O(n^2) pairs. The number of slopes up to t equals the number of inversions
+ * between the X order and the order of y - t x, which a parallel merge sort
+ * counts in O(n log n). Starting from the range of all slopes, each round draws
+ * a Bernoulli sample of about n of the slopes inside the current interval from
+ * the same merge, picks two sample slopes that bracket the target rank with high
+ * probability and counts at both to narrow the interval. Once few enough slopes
+ * remain they are enumerated and selected directly. The slope bounds are the
+ * slopes of Sen's rank interval, the intercept is the median of y - slope x and
+ * the pivot lies at the median X.
+ *
+ * Small series are solved exactly. For large ones the search stops once the
+ * rank is pinned down to 0.5% (median) or 2% (bounds) of the half width of
+ * Sen's interval, well inside the statistical uncertainty of the fit. Above
+ * 2^19 points the slope is fitted on a stratified subsample, one random point
+ * from each of 2^19 consecutive runs of \p data, so the cost no longer grows
+ * with n; the intercept still uses all points.
+ *
+ * \p cancellation is checked between the merge passes of every sort.
+ * Returns an invalid line for fewer than two distinct X values or when \p cancellation fires.
+ */
+TrendLine fitTheilSen(const LineSeries& data, const CancellationToken& cancellation);
@@ -0,0 +1,151 @@
+#include "XAggregation.h"
+
+#include "ParallelUtils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    // Groups reduced by one chunk, concatenated in chunk order afterwards
+    struct ChunkGroups
+    {
+        LineSeries  aggregated;
+        LineSeries  lower;
+        LineSeries  upper;
+    };
+
+    void appendSeries(const LineSeries& source, LineSeries& target, std::size_t offset)
+    {
+        std::copy(source.xData(), source.xData() + source.size(), target.xData() + offset);
+        std::copy(source.yData(), source.yData() + source.size(), target.yData() + offset);
+    }
+}
+
+void aggregateByX(const LineSeries& data, XAggregation aggregation, float binWidth,
+    LineSeries& aggregated, LineSeries& lower, LineSeries& upper, const CancellationToken& cancellation)
+{
+    aggregated.clear();
+    lower.clear();
+    upper.clear();
+
+    const std::size_t n = data.size();
+    if (aggregation == XAggregation::None) {
+        aggregated = data;
+        return;
+    }
+    if (n == 0)
+        return;
+
+    const float* x = data.xData();
+    const float* y = data.yData();
+
+    // Group key of an X value, the value itself or the index of its bin. Both are
+    // non-decreasing in X, so the points of a group are contiguous
+    const bool binned = binWidth > 0.0f;
+    const double origin = x[0];
+    const double inverseWidth = binned ? 1.0 / static_cast<double>(binWidth) : 0.0;
+    const auto keyOf = [binned, origin, inverseWidth](float value) -> double {
+        return binned ? std::floor((static_cast<double>(value) - origin) * inverseWidth) : static_cast<double>(value);
+        };
+
+    // Move every chunk boundary past the end of the group it falls into, found by binary search
+    const std::size_t numChunks = parallelChunkCount(n, std::size_t(1) << 15);
+    std::vector<std::size_t> boundaries(numChunks + 1, n);
+    boundaries[0] = 0;
+    for (std::size_t chunk = 1; chunk < numChunks; ++chunk) {
+        const std::size_t begin = std::max(parallelChunkBegin(n, numChunks, chunk), boundaries[chunk - 1]);
+        if (begin == 0 || begin >= n) {
+            boundaries[chunk] = std::min(begin, n);
+            continue;
+        }
+        const double previousKey = keyOf(x[begin - 1]);
+        boundaries[chunk] = static_cast<std::size_t>(std::partition_point(x + begin, x + n, [&keyOf, previousKey](float value) {
+            return keyOf(value) == previousKey;
+            }) - x);
+    }
+
+    const bool withRange = aggregation != XAggregation::Count;
+    std::vector<ChunkGroups> chunkGroups(numChunks);
+    parallelForChunks(numChunks, numChunks, [&](std::size_t chunk, std::size_t, std::size_t) {
+        if (cancellation.isCancelled())
+            return;
+
+        auto& groups = chunkGroups[chunk];
+        std::vector<float> scratch;
+        const std::size_t end = boundaries[chunk + 1];
+        for (std::size_t groupBegin = boundaries[chunk]; groupBegin < end;) {
+            const double groupKey = keyOf(x[groupBegin]);
+            double sumX = 0.0;
+            double sumY = 0.0;
+            float minY = y[groupBegin];
+            float maxY = y[groupBegin];
+            std::size_t groupEnd = groupBegin;
+            for (; groupEnd < end && keyOf(x[groupEnd]) == groupKey; ++groupEnd) {
+                sumX += x[groupEnd];
+                sumY += y[groupEnd];
+                minY = std::min(minY, y[groupEnd]);
+                maxY = std::max(maxY, y[groupEnd]);
+            }
+
+            const std::size_t count = groupEnd - groupBegin;
+            float value = 0.0f;
+            switch (aggregation) {
+            case XAggregation::Mean:
+                value = static_cast<float>(sumY / static_cast<double>(count));
+                break;
+            case XAggregation::Median: {
+                // Mean of the two middle values for even counts, the lower one is the maximum of the lower half
+                scratch.assign(y + groupBegin, y + groupEnd);
+                const auto middle = scratch.begin() + count / 2;
+                std::nth_element(scratch.begin(), middle, scratch.end());
+                value = *middle;
+                if (count % 2 == 0)
+                    value = 0.5f * (*std::max_element(scratch.begin(), middle) + value);
+                break;
+            }
+            case XAggregation::Minimum:
+                value = minY;
+                break;
+            case XAggregation::Maximum:
+                value = maxY;
+                break;
+            case XAggregation::Count:
+            case XAggregation::None:
+                value = static_cast<float>(count);
+                break;
+            }
+
+            const float groupX = binned ? static_cast<float>(sumX / static_cast<double>(count)) : x[groupBegin];
+            groups.aggregated.append(groupX, value);
+            if (withRange) {
+                groups.lower.append(groupX, minY);
+                groups.upper.append(groupX, maxY);
+            }
+            groupBegin = groupEnd;
+        }
+        });
+
+    if (cancellation.isCancelled())
+        return;
+
+    std::size_t numGroups = 0;
+    for (const auto& groups : chunkGroups)
+        numGroups += groups.aggregated.size();
+    aggregated.resize(numGroups);
+    if (withRange) {
+        lower.resize(numGroups);
+        upper.resize(numGroups);
+    }
+
+    std::size_t offset = 0;
+    for (const auto& groups : chunkGroups) {
+        appendSeries(groups.aggregated, aggregated, offset);
+        if (withRange) {
+            appendSeries(groups.lower, lower, offset);
+            appendSeries(groups.upper, upper, offset);
+        }
+        offset += groups.aggregated.size();
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "CancellationToken.h"
+#include "LinePlotViewPlugin.h" // for XAggregation
+#include "../libs/LineChartLib/LineSeries.h"
+
+/**
+ * Collapse the points of a series sorted by X into one point per X group
+ *
+ * A group is a run of equal X values or, with a positive \p binWidth, the points
+ * whose X falls into the same bin [x0 + k binWidth, x0 + (k + 1) binWidth), with
+ * x0 the smallest X. Exact groups keep their X, bins are placed at the mean X of
+ * their points.
+ *
+ * Since the groups are contiguous runs, the reduction is a single segmented pass:
+ * the series is split into chunks that run in parallel, each chunk boundary moved
+ * forward to the start of the next group so no group straddles two chunks, and
+ * every chunk reduces its own groups into a local buffer. The buffers are
+ * concatenated in chunk order. Medians are selected from a scratch copy of the
+ * group with nth_element, so the whole pass stays linear on average.
+ *
+ * @param data Series sorted by X
+ * @param aggregation Statistic every group is reduced to, XAggregation::None copies \p data
+ * @param binWidth Bin width in X units, 0 groups equal X values
+ * @param aggregated Receives one point per group, ascending in X
+ * @param lower Receives the smallest Y of every group at the X of \p aggregated, empty for counts
+ * @param upper Receives the largest Y of every group at the X of \p aggregated, empty for counts
+ * @param cancellation Checked per chunk, the outputs are incomplete when it fires
+ */
+void aggregateByX(const LineSeries& data, XAggregation aggregation, float binWidth,
+    LineSeries& aggregated, LineSeries& lower, LineSeries& upper, const CancellationToken& cancellation);
@@ -0,0 +1,127 @@
+#include "XWindowSmoothing.h"
+
+#include "RadixSort.h"
+#include "RollingQuantile.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+    /**
+     * Calls step(i, begin, end) for every point i of the X-sorted \p x, where [begin, end)
+     * are the points within \p halfWidth of x[i]; both bounds only move forward
+     */
+    template <typename Step>
+    void forEachXWindow(const float* x, std::size_t n, double halfWidth, Step&& step)
+    {
+        std::size_t begin = 0, end = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            while (end < n && static_cast<double>(x[end]) <= static_cast<double>(x[i]) + halfWidth)
+                ++end;
+            while (static_cast<double>(x[begin]) < static_cast<double>(x[i]) - halfWidth)
+                ++begin;
+            step(i, begin, end);
+        }
+    }
+
+    // Runs smoother(x, y, n, out, scratch) on the X-sorted input; smoothed must not alias the input
+    template <typename Smoother>
+    void smoothInXOrder(const LineSeries& data, LineSeries& smoothed, SmoothingWorkspace* workspace, Smoother&& smoother)
+    {
+        SmoothingWorkspace localWorkspace;
+        SmoothingWorkspace& scratch = workspace ? *workspace : localWorkspace;
+        const LineSeries& input = sortSeriesByX(data, scratch.sorted) ? scratch.sorted : data;
+        smoothed.resize(input.size());
+        std::copy_n(input.xData(), input.size(), smoothed.xData());
+        smoother(input.xData(), input.yData(), input.size(), smoothed.yData(), scratch);
+    }
+
+    void xWindowMean(const float* x, const float* y, std::size_t n, double halfWidth, float* out, std::vector<double>& prefix)
+    {
+        // Window sums as differences of double prefix sums
+        prefix.assign(n + 1, 0.0);
+        for (std::size_t i = 0; i < n; ++i)
+            prefix[i + 1] = prefix[i] + y[i];
+
+        forEachXWindow(x, n, halfWidth, [&](std::size_t i, std::size_t begin, std::size_t end) {
+            out[i] = static_cast<float>((prefix[end] - prefix[begin]) / static_cast<double>(end - begin));
+            });
+    }
+
+    // Running extreme over the window; the queue holds the candidates in index order with values ordered by before()
+    template <typename Before>
+    void xWindowExtreme(const float* x, const float* y, std::size_t n, double halfWidth, float* out, std::vector<std::uint32_t>& queue, Before before)
+    {
+        queue.clear();
+        queue.reserve(n);
+        std::size_t head = 0, pushed = 0;
+
+        forEachXWindow(x, n, halfWidth, [&](std::size_t i, std::size_t begin, std::size_t end) {
+            for (; pushed < end; ++pushed) {
+                while (queue.size() > head && !before(y[queue.back()], y[pushed]))
+                    queue.pop_back();
+                queue.push_back(static_cast<std::uint32_t>(pushed));
+            }
+            while (queue[head] < begin)
+                ++head;
+            out[i] = y[queue[head]];
+            });
+    }
+}
+
+void applyXWindowMean(const LineSeries& data, float width, LineSeries& smoothed, SmoothingWorkspace* workspace)
+{
+    smoothInXOrder(data, smoothed, workspace, [width](const float* x, const float* y, std::size_t n, float* out, SmoothingWorkspace& scratch) {
+        xWindowMean(x, y, n, 0.5 * std::max(width, 0.0f), out, scratch.sums);
+        });
+}
+
+void applyXWindowMedian(const LineSeries& data, float width, LineSeries& smoothed, SmoothingWorkspace* workspace)
+{
+    smoothInXOrder(data, smoothed, workspace, [width](const float* x, const float* y, std::size_t n, float* out, SmoothingWorkspace& scratch) {
+        RollingQuantile& window = scratch.quantile;
+        window.clear();
+        window.setQuantile(0.5);
+        std::vector<RollingQuantile::Handle>& handles = scratch.indices;
+        handles.resize(n);
+        std::size_t inserted = 0, erased = 0;
+
+        forEachXWindow(x, n, 0.5 * std::max(width, 0.0f), [&](std::size_t i, std::size_t begin, std::size_t end) {
+            for (; inserted < end; ++inserted)
+                handles[inserted] = window.insert(y[inserted]);
+            for (; erased < begin; ++erased)
+                window.erase(handles[erased]);
+            out[i] = window.value();
+            });
+        });
+}
+
+void applyXWindowMinimum(const LineSeries& data, float width, LineSeries& smoothed, SmoothingWorkspace* workspace)
+{
+    smoothInXOrder(data, smoothed, workspace, [width](const float* x, const float* y, std::size_t n, float* out, SmoothingWorkspace& scratch) {
+        xWindowExtreme(x, y, n, 0.5 * std::max(width, 0.0f), out, scratch.indices, [](float a, float b) { return a < b; });
+        });
+}
+
+void applyXWindowMaximum(const LineSeries& data, float width, LineSeries& smoothed, SmoothingWorkspace* workspace)
+{
+    smoothInXOrder(data, smoothed, workspace, [width](const float* x, const float* y, std::size_t n, float* out, SmoothingWorkspace& scratch) {
+        xWindowExtreme(x, y, n, 0.5 * std::max(width, 0.0f), out, scratch.indices, [](float a, float b) { return a > b; });
+        });
+}
+
+void applyXWindowGaussian(const LineSeries& data, float width, LineSeries& smoothed, SmoothingWorkspace* workspace)
+{
+    // Three boxes of half-width a have variance a^2, so a = sigma
+    const double sigma = std::max(width, 0.0f) / 6.0;
+    smoothInXOrder(data, smoothed, workspace, [sigma](const float* x, const float* y, std::size_t n, float* out, SmoothingWorkspace& scratch) {
+        std::vector<float>& pass = scratch.values;
+        pass.assign(y, y + n);
+        for (int i = 0; i < 3; ++i) {
+            xWindowMean(x, pass.data(), n, sigma, out, scratch.sums);
+            std::copy_n(out, n, pass.data());
+        }
+        });
+}
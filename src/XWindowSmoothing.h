@@ -0,0 +1,38 @@
+#pragma once
+
+#include "SmoothingWorkspace.h"
+#include "../libs/LineChartLib/LineSeries.h"
+
+/**
+ * Smoothers with windows measured along X rather than in samples
+ *
+ * Every point is replaced by a statistic of the points whose X lies within
+ * width / 2 of its own, so irregularly spaced data (pseudotime, spatial
+ * coordinates) is smoothed evenly along the axis. The window bounds advance
+ * monotonically with the point, so each smoother visits every point a constant
+ * number of times and runs in O(n), O(n log w) for the median.
+ *
+ * The output keeps the input X. Input that is not sorted by X is smoothed in X
+ * order and returned in X order. A workspace, when given, holds the sorted copy
+ * and the window buffers between calls.
+ */
+
+/** Mean of each window */
+void applyXWindowMean(const LineSeries& data, float width, LineSeries& smoothed, SmoothingWorkspace* workspace = nullptr);
+
+/** Median of each window */
+void applyXWindowMedian(const LineSeries& data, float width, LineSeries& smoothed, SmoothingWorkspace* workspace = nullptr);
+
+/** Minimum of each window */
+void applyXWindowMinimum(const LineSeries& data, float width, LineSeries& smoothed, SmoothingWorkspace* workspace = nullptr);
+
+/** Maximum of each window */
+void applyXWindowMaximum(const LineSeries& data, float width, LineSeries& smoothed, SmoothingWorkspace* workspace = nullptr);
+
+/**
+ * Gaussian weighted mean with standard deviation width / 6 in X
+ *
+ * Approximated by three passes of the X-window mean with half-width sigma,
+ * which together have the variance of the Gaussian and converge to its shape.
+ */
+void applyXWindowGaussian(const LineSeries& data, float width, LineSeries& smoothed, SmoothingWorkspace* workspace = nullptr);